@@ -0,0 +1,269 @@
+// 基准测试套件：递归、排序、字符串、矩阵、列表过程以及读取源码的吞吐量。
+// 结果以 JSON 输出：每个用例每次操作的纳秒数与分配次数，以及整个进程的峰值常驻内存，便于长期跟踪。
+// 用法：mini_lisp_bench [-o 输出文件] [名字子串]，给出子串时只运行名字包含它的用例。
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "builtins.h"
+#include "eval_env.h"
+#include "parser.h"
+#include "stats.h"
+#include "tokenizer.h"
+#include "value.h"
+
+namespace {
+
+// 每个用例至少运行的时间与次数
+constexpr double MIN_SECONDS = 0.2;
+constexpr std::size_t MIN_ITERATIONS = 3;
+
+struct Result {
+    std::string name;
+    std::size_t n;
+    std::size_t iterations;
+    double nsPerOp;
+    double allocationsPerOp;
+};
+
+// 进程的峰值常驻内存（字节），只增不减，因此只在整套用例结束后报告一次。Windows 下不统计
+long long peakRss() {
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024LL;
+#endif
+#else
+    return 0;
+#endif
+}
+
+class Suite {
+public:
+    explicit Suite(std::string filter) : filter(std::move(filter)) {}
+
+    // 计时时关闭统计；之后单独运行一次，只统计分配次数
+    void measure(const std::string& name, std::size_t n, const std::function<void()>& body) {
+        if (name.find(filter) == std::string::npos) return;
+        body();
+        std::size_t iterations = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed{};
+        while (iterations < MIN_ITERATIONS || elapsed.count() < MIN_SECONDS) {
+            body();
+            iterations++;
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        collectingStats = true;
+        auto before = allocationCount();
+        body();
+        auto allocations = allocationCount() - before;
+        collectingStats = false;
+        results.push_back({name, n, iterations, elapsed.count() * 1e9 / iterations,
+                           static_cast<double>(allocations)});
+        std::cerr << name << "/" << n << ": " << results.back().nsPerOp << " ns/op" << std::endl;
+    }
+
+    void write(std::ostream& out) const {
+        out << "{\n  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const auto& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"n\": " << r.n
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << static_cast<long long>(r.nsPerOp)
+                << ", \"allocations_per_op\": " << static_cast<long long>(r.allocationsPerOp) << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ],\n  \"peak_rss_bytes\": " << peakRss() << "\n}" << std::endl;
+    }
+
+private:
+    std::string filter;
+    std::vector<Result> results;
+};
+
+std::vector<ValuePtr> parseAll(const std::string& source) {
+    Parser parser(Tokenizer::tokenize(source));
+    std::vector<ValuePtr> forms;
+    while (!parser.isEnd()) forms.push_back(parser.parse());
+    return forms;
+}
+
+ValuePtr run(EvalEnv& env, const std::string& source) {
+    ValuePtr result;
+    for (auto& form : parseAll(source)) result = env.eval(std::move(form));
+    return result;
+}
+
+std::vector<ValuePtr> numbers(std::size_t n) {
+    std::vector<ValuePtr> result;
+    result.reserve(n);
+    for (std::size_t i = 0; i < n; i++) result.push_back(std::make_shared<NumericValue>(i));
+    return result;
+}
+
+// 线性同余生成的伪随机整数列表，写成 Lisp 源码，与 lv7-answer.scm 中的输入同一形式
+std::string randomList(std::size_t n) {
+    std::ostringstream out;
+    unsigned state = 12345;
+    out << "'(";
+    for (std::size_t i = 0; i < n; i++) {
+        state = state * 1103515245u + 12345u;
+        out << (i ? " " : "") << (state >> 16) % 1000;
+    }
+    out << ")";
+    return out.str();
+}
+
+// 对角占优的 n 阶方阵，保证可逆
+std::string matrixSource(std::size_t n) {
+    std::ostringstream out;
+    out << "(matrix-set";
+    for (std::size_t i = 0; i < n; i++) {
+        out << " '(";
+        for (std::size_t j = 0; j < n; j++) {
+            out << (j ? " " : "") << (i == j ? 10 * n : (i * 7 + j * 3) % 10);
+        }
+        out << ")";
+    }
+    out << ")";
+    return out.str();
+}
+
+const std::string RECURSION = R"(
+(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))
+(define (tak x y z)
+  (if (not (< y x)) z
+      (tak (tak (- x 1) y z) (tak (- y 1) z x) (tak (- z 1) x y))))
+(define (ack m n)
+  (cond ((= m 0) (+ n 1))
+        ((= n 0) (ack (- m 1) 1))
+        (else (ack (- m 1) (ack m (- n 1))))))
+)";
+
+const std::string SORTING = R"(
+(define (insert-sort lst)
+  (define (insert x sorted)
+    (if (null? sorted)
+        (list x)
+        (if (< x (car sorted)) (cons x sorted) (cons (car sorted) (insert x (cdr sorted))))))
+  (if (null? lst) '() (insert (car lst) (insert-sort (cdr lst)))))
+(define (merge a b)
+  (cond ((null? a) b)
+        ((null? b) a)
+        ((< (car a) (car b)) (cons (car a) (merge (cdr a) b)))
+        (else (cons (car b) (merge a (cdr b))))))
+(define (split lst)
+  (if (or (null? lst) (null? (cdr lst)))
+      (cons lst '())
+      (let ((rest (split (cdr (cdr lst)))))
+        (cons (cons (car lst) (car rest)) (cons (car (cdr lst)) (cdr rest))))))
+(define (merge-sort lst)
+  (if (or (null? lst) (null? (cdr lst)))
+      lst
+      (let ((halves (split lst)))
+        (merge (merge-sort (car halves)) (merge-sort (cdr halves))))))
+)";
+
+const std::string STRINGS = R"(
+(define (build-string n)
+  (let loop ((i 0) (s ""))
+    (if (= i n) s (loop (+ i 1) (string-append s (number->string i) " ")))))
+)";
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string outputPath;
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            filter = arg;
+        }
+    }
+    Suite suite(filter);
+
+    std::shared_ptr<EvalEnv> env{new EvalEnv};
+    run(*env, RECURSION + SORTING + STRINGS);
+    auto fib = parseAll("(fib 20)")[0];
+    auto tak = parseAll("(tak 18 12 6)")[0];
+    auto ack = parseAll("(ack 2 9)")[0];
+    suite.measure("fib", 20, [&] { env->eval(fib); });
+    suite.measure("tak", 18, [&] { env->eval(tak); });
+    suite.measure("ackermann", 9, [&] { env->eval(ack); });
+
+    for (std::size_t n : {100, 1000}) {
+        run(*env, "(define input " + randomList(n) + ")");
+        auto insertSort = parseAll("(insert-sort input)")[0];
+        auto mergeSort = parseAll("(merge-sort input)")[0];
+        auto sort = parseAll("(sort input <)")[0];
+        suite.measure("insert-sort", n, [&] { env->eval(insertSort); });
+        suite.measure("merge-sort", n, [&] { env->eval(mergeSort); });
+        suite.measure("sort", n, [&] { env->eval(sort); });
+    }
+
+    for (std::size_t n : {100, 1000}) {
+        auto build = parseAll("(build-string " + std::to_string(n) + ")")[0];
+        suite.measure("string-append", n, [&] { env->eval(build); });
+    }
+
+    for (std::size_t n : {4, 16, 64}) {
+        run(*env, "(define m " + matrixSource(n) + ")");
+        auto multiply = parseAll("(@ m m)")[0];
+        auto transpose = parseAll("(T m)")[0];
+        suite.measure("matrix-multiply", n, [&] { env->eval(multiply); });
+        suite.measure("matrix-transpose", n, [&] { env->eval(transpose); });
+    }
+    // det 与 inverse 按余子式展开，耗时随阶数阶乘增长，只测小矩阵
+    for (std::size_t n : {4, 7}) {
+        run(*env, "(define m " + matrixSource(n) + ")");
+        auto det = parseAll("(det m)")[0];
+        auto inverse = parseAll("(inverse m)")[0];
+        suite.measure("matrix-det", n, [&] { env->eval(det); });
+        suite.measure("matrix-inverse", n, [&] { env->eval(inverse); });
+    }
+
+    // 吞吐量用例的 n 为源码字节数
+    std::string source;
+    while (source.size() < 100000) source += SORTING + "(define input " + randomList(50) + ")\n";
+    // 词法单元不可复制，read 包含词法分析与语法分析两步
+    suite.measure("tokenize", source.size(), [&] { Tokenizer::tokenize(source); });
+    suite.measure("read", source.size(), [&] { parseAll(source); });
+
+    auto identity = env->lookupBinding("abs");
+    auto even = env->lookupBinding("even?");
+    auto map = env->lookupBinding("map");
+    auto forEach = env->lookupBinding("for-each");
+    auto filterProc = env->lookupBinding("filter");
+    for (std::size_t n : {100000, 1000000}) {
+        auto args = numbers(n);
+        auto lst = list(args);
+        suite.measure("list", n, [&] { list(args); });
+        suite.measure("append", n, [&] { append({lst, lst}); });
+        suite.measure("map", n, [&] { env->apply(map, {identity, lst}); });
+        suite.measure("for-each", n, [&] { env->apply(forEach, {identity, lst}); });
+        suite.measure("filter", n, [&] { env->apply(filterProc, {even, lst}); });
+    }
+
+    if (outputPath.empty()) {
+        suite.write(std::cout);
+    } else {
+        std::ofstream out(outputPath);
+        suite.write(out);
+    }
+    return 0;
+}
@@ -1,6 +1,13 @@
 #include "./builtins.h"
 #include "./error.h"
+#include "./eval_env.h"
 #include "./forms.h"
+#include "./channel.h"
+#include "./future.h"
+#include "./promise.h"
+#include "./stats.h"
+#include <cmath>
+#include <limits>
 
 
 using namespace std::literals;
@@ -131,11 +138,17 @@ ValuePtr isList(const std::vector<ValuePtr>& args){
     if(args.size()!=1){
         throw LispError("list procedure takes 1 argument");
     }
-    ValuePtr arg = args[0];
-    if(arg->isNil()||arg->isPair()&&arg->toString().find(".") == std::string::npos){
-        return std::make_shared<BooleanValue>(true);
+    // 快慢指针同时前进，正规列表以空表结束，带环的列表不是列表
+    const Value* slow = args[0].get();
+    const Value* fast = args[0].get();
+    while(fast->isPair()){
+        fast = static_cast<const PairValue*>(fast)->getCdr().get();
+        if(!fast->isPair()) break;
+        fast = static_cast<const PairValue*>(fast)->getCdr().get();
+        slow = static_cast<const PairValue*>(slow)->getCdr().get();
+        if(fast == slow) return std::make_shared<BooleanValue>(false);
     }
-    return std::make_shared<BooleanValue>(false);
+    return std::make_shared<BooleanValue>(fast->isNil());
 }
 
 ValuePtr isNumber(const std::vector<ValuePtr>& args){
@@ -208,15 +221,23 @@ ValuePtr append(const std::vector<ValuePtr>& args){
     if(args.empty()){
         return std::make_shared<NilValue>();
     }
+    // 最后一个列表参数直接作为结果的末尾共享，不再复制
+    auto last = args.end();
+    ValuePtr tail = std::make_shared<NilValue>();
+    if(args.back()->isPair() || args.back()->isNil()){
+        --last;
+        tail = args.back();
+    }
     std::vector<ValuePtr> result;
-    for(const auto& arg : args){
-        std::vector<ValuePtr> temp;
-        if(arg->isPair()) temp = arg->toVector();
+    for(auto it = args.begin(); it != last; ++it){
+        const auto& arg = *it;
+        if(arg->isPair()){
+            forEachInList(arg, [&](const ValuePtr& value) { result.push_back(value); });
+        }
         else if (arg->isNil()) continue;
-        else temp = {arg};
-        std::copy(temp.begin(), temp.end(), std::back_inserter(result));
+        else result.push_back(arg);
     }
-    return list(result);
+    return makeList(result.begin(), result.end(), tail);
 }
 ValuePtr car(const std::vector<ValuePtr>& args){
     if(args.size()!=1){
@@ -226,6 +247,7 @@ ValuePtr car(const std::vector<ValuePtr>& args){
     if(arg->isPair()){
         //强制类型转换为PairValue的指针
         auto pairExpr = std::dynamic_pointer_cast<PairValue>(arg);
+        ValueReadLock lock(*pairExpr);
         return pairExpr->CAR();
     }
     throw LispError("car procedure takes a pair as argument");
@@ -239,6 +261,7 @@ ValuePtr cdr(const std::vector<ValuePtr>& args){
     if(arg->isPair()){
         //强制类型转换为PairValue的指针
         auto pairExpr = std::dynamic_pointer_cast<PairValue>(arg);
+        ValueReadLock lock(*pairExpr);
         return pairExpr->CDR();
     }
     throw LispError("cdr procedure takes a pair as argument");
@@ -253,22 +276,52 @@ ValuePtr cons(const std::vector<ValuePtr>& args){
     return std::make_shared<PairValue>(car,cdr);
 }
 
+ValuePtr setCar(const std::vector<ValuePtr>& args){
+    if(args.size()!=2){
+        throw LispError("set-car! procedure takes 2 arguments");
+    }
+    if(!args[0]->isPair()){
+        throw LispError("set-car! procedure takes a pair as its first argument");
+    }
+    ValueWriteLock lock(*args[0]);
+    static_cast<PairValue&>(*args[0]).setCar(args[1]);
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr setCdr(const std::vector<ValuePtr>& args){
+    if(args.size()!=2){
+        throw LispError("set-cdr! procedure takes 2 arguments");
+    }
+    if(!args[0]->isPair()){
+        throw LispError("set-cdr! procedure takes a pair as its first argument");
+    }
+    ValueWriteLock lock(*args[0]);
+    static_cast<PairValue&>(*args[0]).setCdr(args[1]);
+    return std::make_shared<NilValue>();
+}
+
 ValuePtr length(const std::vector<ValuePtr>& args){
     if(args.size()!=1){
         throw LispError("length procedure takes 1 argument");
     }
-    auto result = args[0]->toVector().size();
+    // 沿 cdr 逐个计数，不复制元素；慢指针每两步前进一次，追上快指针说明列表带环
+    std::size_t result = 0;
+    const Value* current = args[0].get();
+    const Value* slow = current;
+    while(current->isPair()){
+        result++;
+        current = static_cast<const PairValue*>(current)->getCdr().get();
+        if(result % 2 == 0) slow = static_cast<const PairValue*>(slow)->getCdr().get();
+        if(current == slow) throw LispError("length expects a proper list");
+    }
+    if(!current->isNil()){
+        throw LispError("length expects a proper list");
+    }
     return std::make_shared<NumericValue>(result);
 }
 
 ValuePtr list(const std::vector<ValuePtr>& args){
-    if(args.empty()){
-        // 如果没有参数，返回一个空的PairValue表示空列表
-        return std::make_shared<NilValue>();
-    }
-    auto car = args.front();
-    std::vector<ValuePtr> cdr(args.begin() + 1, args.end());
-    return std::make_shared<PairValue>(car, list(cdr));
+    return makeList(args.begin(), args.end());
 }
 
 ValuePtr add(const std::vector<ValuePtr>& params) {
@@ -342,7 +395,6 @@ ValuePtr times(const std::vector<ValuePtr>& params){
     if(params.empty()) return std::make_shared<NumericValue>(1);
     bool matrixFlag = false;
     int rows = 0;
-    int cols = 0;
     for(size_t i = 0; i < params.size(); i++){
         if(!params[i]->isNumber() && !params[i]->isMatrix()){
             throw LispError("Multiply expects number(s) or Matrix(es).");
@@ -350,7 +402,6 @@ ValuePtr times(const std::vector<ValuePtr>& params){
         if(params[i]->isMatrix()){
             matrixFlag = true;
             rows = params[i]->getrows();
-            cols = params[i]->getcols();
             break;
         }
     }
@@ -536,25 +587,73 @@ ValuePtr remainder(const std::vector<ValuePtr>& params) {
     return std::make_shared<NumericValue>(d - k * s);
 }
 
+// eqv? 语义：同一对象，或同为数（精确性相同且数值相等）、布尔、空表、同名符号
+static bool eqvValues(const Value* lhs, const Value* rhs){
+    if(lhs == rhs) return true;
+    if(lhs->isNumber() && rhs->isNumber()){
+        return lhs->isRational() == rhs->isRational() && lhs->asNumber() == rhs->asNumber();
+    }
+    if(lhs->isBool() && rhs->isBool()) return lhs->asBool() == rhs->asBool();
+    if(lhs->isNil() && rhs->isNil()) return true;
+    if(lhs->isSymbol() && rhs->isSymbol()){
+        return static_cast<const SymbolValue*>(lhs)->getName() == static_cast<const SymbolValue*>(rhs)->getName();
+    }
+    return false;
+}
+
+bool isEqv(const ValuePtr& lhs, const ValuePtr& rhs){
+    return eqvValues(lhs.get(), rhs.get());
+}
+
+// equal? 语义：逐层比较结构，遇到第一处不同立即返回；沿 cdr 方向迭代
+bool isEqual(const ValuePtr& lhs, const ValuePtr& rhs){
+    const Value* left = lhs.get();
+    const Value* right = rhs.get();
+    while(left->isPair() && right->isPair()){
+        if(left == right) return true;
+        auto leftPair = static_cast<const PairValue*>(left);
+        auto rightPair = static_cast<const PairValue*>(right);
+        if(!isEqual(leftPair->getCar(), rightPair->getCar())) return false;
+        left = leftPair->getCdr().get();
+        right = rightPair->getCdr().get();
+    }
+    if(left->isString() && right->isString()){
+        return static_cast<const StringValue*>(left)->getValue() == static_cast<const StringValue*>(right)->getValue();
+    }
+    if(left->isVector() && right->isVector()){
+        const auto& leftElements = static_cast<const VectorValue*>(left)->getElements();
+        const auto& rightElements = static_cast<const VectorValue*>(right)->getElements();
+        if(leftElements.size() != rightElements.size()) return false;
+        for(std::size_t i = 0; i < leftElements.size(); i++){
+            if(!isEqual(leftElements[i], rightElements[i])) return false;
+        }
+        return true;
+    }
+    if(left->isMatrix() && right->isMatrix()){
+        return *static_cast<const MatrixValue*>(left) == *static_cast<const MatrixValue*>(right);
+    }
+    return eqvValues(left, right);
+}
+
 ValuePtr eq(const std::vector<ValuePtr>& params){
     if(params.size() != 2){
         throw LispError("Eq expects exactly two arguments.");
     }
-    if(params[0]->isString() || params[0]->isPair()){
-        bool result = (params[0] == params[1]);
-        return std::make_shared<BooleanValue>(result);
-    } else {
-        bool result = (params[0]->toString() == params[1]->toString());
-        return std::make_shared<BooleanValue>(result);
+    return std::make_shared<BooleanValue>(isEqv(params[0], params[1]));
+}
+
+ValuePtr eqv(const std::vector<ValuePtr>& params){
+    if(params.size() != 2){
+        throw LispError("Eqv expects exactly two arguments.");
     }
+    return std::make_shared<BooleanValue>(isEqv(params[0], params[1]));
 }
 
 ValuePtr equal(const std::vector<ValuePtr>& params){
     if(params.size() != 2){
         throw LispError("Equal expects exactly two arguments.");
     }
-    bool result = (params[0]->toString() == params[1]->toString());
-    return std::make_shared<BooleanValue>(result);
+    return std::make_shared<BooleanValue>(isEqual(params[0], params[1]));
 }
 
 ValuePtr equal_num(const std::vector<ValuePtr>& params){
@@ -806,7 +905,7 @@ ValuePtr strRef(const std::vector<ValuePtr>& params){
     if(pos < 0 || (params[1]->asNumber() != static_cast<int>(params[1]->asNumber()))){
         throw LispError("string-ref expects a non-negative integer as its second argument.");
     }
-    if(params[0]->asString().size() <= pos){
+    if(params[0]->asString().size() <= static_cast<std::size_t>(pos)){
         throw LispError("string-ref expects a position that is less than the length of the string.");
     }
     return std::make_shared<StringValue>(std::string(1, params[0]->asString()[pos]));
@@ -859,13 +958,13 @@ ValuePtr subStr(const std::vector<ValuePtr>& params){
         if(!params[2]->isNumber()){
             throw LispError("subString expects a number as its third argument.");
         }
-        if(params[2]->asNumber() != static_cast<int>(params[2]->asNumber())){
+        if(params[2]->asNumber() < 0 || params[2]->asNumber() != static_cast<int>(params[2]->asNumber())){
             throw LispError("subString expects a non-negative integer as its third argument.");
         }
         num = params[2]->asNumber();
     }
     
-    if (num < 0 || pos < 0 || pos >= str.size()){
+    if (pos < 0 || static_cast<std::size_t>(pos) >= str.size()){
         throw LispError("illegal subString.");
     }
     return std::make_shared<StringValue>(str.substr(pos, num));
@@ -1016,7 +1115,6 @@ ValuePtr matrixSet(const std::vector<ValuePtr>& params){
     if(params.empty()){
         throw LispError("matrix-set expects at least one argument.");
     }
-    int rows = params.size();
     if(!params[0]->isPair()){
         throw LispError("matrix-set expects a list of lists.");
     }
@@ -1148,7 +1246,289 @@ ValuePtr matrixInverse(const std::vector<ValuePtr>& params){
     return std::make_shared<MatrixValue>(matrix.inverse());
 }
 
-std::unordered_map<std::string, BuiltinProc> builtinProcs = {
+// 检查并取出向量参数
+static VectorValue& asVector(const ValuePtr& value, const std::string& procName){
+    if(!value->isVector()){
+        throw LispError(procName + " expects a vector as its first argument.");
+    }
+    return static_cast<VectorValue&>(*value);
+}
+
+// 检查下标为范围内的整数
+static std::size_t vectorIndex(const VectorValue& vec, const ValuePtr& index, const std::string& procName){
+    if(!index->isNumber() || index->asNumber() != static_cast<long long>(index->asNumber())){
+        throw LispError(procName + " expects an integer index.");
+    }
+    auto k = static_cast<long long>(index->asNumber());
+    if(k < 0 || static_cast<std::size_t>(k) >= vec.size()){
+        throw LispError(procName + ": index " + std::to_string(k) + " out of range.");
+    }
+    return static_cast<std::size_t>(k);
+}
+
+ValuePtr isVector(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("vector? expects exactly one argument.");
+    }
+    return std::make_shared<BooleanValue>(params[0]->isVector());
+}
+
+ValuePtr makeVector(const std::vector<ValuePtr>& params){
+    if(params.size() != 1 && params.size() != 2){
+        throw LispError("make-vector expects one or two arguments.");
+    }
+    if(!params[0]->isNumber() || params[0]->asNumber() < 0 ||
+       params[0]->asNumber() != static_cast<long long>(params[0]->asNumber())){
+        throw LispError("make-vector expects a non-negative integer length.");
+    }
+    ValuePtr fill = params.size() == 2 ? params[1] : std::make_shared<NumericValue>(0);
+    std::vector<ValuePtr> elements(static_cast<std::size_t>(params[0]->asNumber()), fill);
+    return std::make_shared<VectorValue>(std::move(elements));
+}
+
+ValuePtr vector(const std::vector<ValuePtr>& params){
+    return std::make_shared<VectorValue>(params);
+}
+
+ValuePtr vectorRef(const std::vector<ValuePtr>& params){
+    if(params.size() != 2){
+        throw LispError("vector-ref expects exactly two arguments.");
+    }
+    auto& vec = asVector(params[0], "vector-ref");
+    ValueReadLock lock(vec);
+    return vec.getElements()[vectorIndex(vec, params[1], "vector-ref")];
+}
+
+ValuePtr vectorSet(const std::vector<ValuePtr>& params){
+    if(params.size() != 3){
+        throw LispError("vector-set! expects exactly three arguments.");
+    }
+    auto& vec = asVector(params[0], "vector-set!");
+    ValueWriteLock lock(vec);
+    vec.getElements()[vectorIndex(vec, params[1], "vector-set!")] = params[2];
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr vectorLength(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("vector-length expects exactly one argument.");
+    }
+    return std::make_shared<NumericValue>(asVector(params[0], "vector-length").size());
+}
+
+ValuePtr vectorFill(const std::vector<ValuePtr>& params){
+    if(params.size() != 2){
+        throw LispError("vector-fill! expects exactly two arguments.");
+    }
+    auto& vec = asVector(params[0], "vector-fill!");
+    ValueWriteLock lock(vec);
+    auto& elements = vec.getElements();
+    std::fill(elements.begin(), elements.end(), params[1]);
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr vector2List(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("vector->list expects exactly one argument.");
+    }
+    const auto& vec = asVector(params[0], "vector->list");
+    ValueReadLock lock(vec);
+    const auto& elements = vec.getElements();
+    return makeList(elements.begin(), elements.end());
+}
+
+ValuePtr list2Vector(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("list->vector expects exactly one argument.");
+    }
+    if(!params[0]->isPair() && !params[0]->isNil()){
+        throw LispError("list->vector expects a list.");
+    }
+    std::vector<ValuePtr> elements;
+    forEachInList(params[0], [&](const ValuePtr& value) { elements.push_back(value); });
+    return std::make_shared<VectorValue>(std::move(elements));
+}
+
+// 检查并取出哈希表参数
+static HashTableValue& asHashTable(const ValuePtr& value, const std::string& procName){
+    if(!value->isHashTable()){
+        throw LispError(procName + " expects a hash table as its first argument.");
+    }
+    return static_cast<HashTableValue&>(*value);
+}
+
+ValuePtr isHashTable(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("hash-table? expects exactly one argument.");
+    }
+    return std::make_shared<BooleanValue>(params[0]->isHashTable());
+}
+
+ValuePtr makeHashTable(const std::vector<ValuePtr>& params){
+    if(!params.empty()){
+        throw LispError("make-hash-table expects no arguments.");
+    }
+    return std::make_shared<HashTableValue>();
+}
+
+ValuePtr hashRef(const std::vector<ValuePtr>& params){
+    if(params.size() != 2 && params.size() != 3){
+        throw LispError("hash-ref expects two or three arguments.");
+    }
+    auto& table = asHashTable(params[0], "hash-ref");
+    ValuePtr value;
+    {
+        ValueReadLock lock(table);
+        value = table.find(params[1]);
+    }
+    if(value){
+        return value;
+    }
+    if(params.size() == 3){
+        return params[2];
+    }
+    throw LispError("hash-ref: no value found for key " + params[1]->toString());
+}
+
+ValuePtr hashSet(const std::vector<ValuePtr>& params){
+    if(params.size() != 3){
+        throw LispError("hash-set! expects exactly three arguments.");
+    }
+    auto& table = asHashTable(params[0], "hash-set!");
+    ValueWriteLock lock(table);
+    table.insert(params[1], params[2]);
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr hashRemove(const std::vector<ValuePtr>& params){
+    if(params.size() != 2){
+        throw LispError("hash-remove! expects exactly two arguments.");
+    }
+    auto& table = asHashTable(params[0], "hash-remove!");
+    ValueWriteLock lock(table);
+    table.erase(params[1]);
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr hashCount(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("hash-count expects exactly one argument.");
+    }
+    auto& table = asHashTable(params[0], "hash-count");
+    ValueReadLock lock(table);
+    return std::make_shared<NumericValue>(table.size());
+}
+
+ValuePtr hashKeys(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("hash-keys expects exactly one argument.");
+    }
+    auto& table = asHashTable(params[0], "hash-keys");
+    std::vector<ValuePtr> keys;
+    {
+        ValueReadLock lock(table);
+        keys = table.keys();
+    }
+    return makeList(keys.begin(), keys.end());
+}
+
+ValuePtr isFuture(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("future? expects exactly one argument.");
+    }
+    return std::make_shared<BooleanValue>(dynamic_cast<const FutureValue*>(params[0].get()) != nullptr);
+}
+
+// 不是 future 的值原样返回
+ValuePtr touch(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("touch expects exactly one argument.");
+    }
+    if(auto future = dynamic_cast<FutureValue*>(params[0].get())){
+        return future->touch();
+    }
+    return params[0];
+}
+
+// 检查并取出通道参数
+static ChannelValue& asChannel(const ValuePtr& value, const std::string& procName){
+    auto channel = dynamic_cast<ChannelValue*>(value.get());
+    if(!channel){
+        throw LispError(procName + " expects a channel as its first argument.");
+    }
+    return *channel;
+}
+
+ValuePtr isChannel(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("channel? expects exactly one argument.");
+    }
+    return std::make_shared<BooleanValue>(dynamic_cast<const ChannelValue*>(params[0].get()) != nullptr);
+}
+
+ValuePtr makeChannel(const std::vector<ValuePtr>& params){
+    if(params.size() > 1){
+        throw LispError("make-channel expects at most one argument.");
+    }
+    std::size_t capacity = 64;
+    if(params.size() == 1){
+        if(!params[0]->isNumber() || params[0]->asNumber() < 1){
+            throw LispError("make-channel expects a positive capacity.");
+        }
+        capacity = static_cast<std::size_t>(params[0]->asNumber());
+    }
+    return std::make_shared<ChannelValue>(capacity);
+}
+
+ValuePtr channelSend(const std::vector<ValuePtr>& params){
+    if(params.size() != 2){
+        throw LispError("channel-send expects exactly two arguments.");
+    }
+    asChannel(params[0], "channel-send").send(params[1]);
+    return std::make_shared<NilValue>();
+}
+
+// 通道已满时不等待，返回 #f
+ValuePtr channelTrySend(const std::vector<ValuePtr>& params){
+    if(params.size() != 2){
+        throw LispError("channel-try-send expects exactly two arguments.");
+    }
+    return std::make_shared<BooleanValue>(asChannel(params[0], "channel-try-send").trySend(params[1]));
+}
+
+// 通道关闭且取空后返回 default（缺省为空表）
+ValuePtr channelRecv(const std::vector<ValuePtr>& params){
+    if(params.size() != 1 && params.size() != 2){
+        throw LispError("channel-recv expects one or two arguments.");
+    }
+    if(auto value = asChannel(params[0], "channel-recv").receive()){
+        return *value;
+    }
+    return params.size() == 2 ? params[1] : std::make_shared<NilValue>();
+}
+
+ValuePtr channelClose(const std::vector<ValuePtr>& params){
+    if(params.size() != 1){
+        throw LispError("channel-close expects exactly one argument.");
+    }
+    asChannel(params[0], "channel-close").close();
+    return std::make_shared<NilValue>();
+}
+
+// 以关联列表返回运行时统计，未开启 --stats 时各项均为 0
+ValuePtr runtimeStats(const std::vector<ValuePtr>& params){
+    if(!params.empty()){
+        throw LispError("runtime-stats expects no arguments.");
+    }
+    std::vector<ValuePtr> entries;
+    for(const auto& [name, value] : statsSnapshot()){
+        entries.push_back(std::make_shared<PairValue>(std::make_shared<SymbolValue>(name),
+                                                      std::make_shared<NumericValue>(static_cast<double>(value))));
+    }
+    return list(entries);
+}
+
+const std::unordered_map<std::string, BuiltinProc> builtinProcs = {
     //核心库：
     {"display", &display},
     {"displayln",&displayln},
@@ -1172,6 +1552,8 @@ std::unordered_map<std::string, BuiltinProc> builtinProcs = {
     {"car", &car},
     {"cdr", &cdr},
     {"cons", &cons},
+    {"set-car!", &setCar},
+    {"set-cdr!", &setCdr},
     {"list", &list},
     {"length", &length},
     //算术运算库：
@@ -1187,6 +1569,7 @@ std::unordered_map<std::string, BuiltinProc> builtinProcs = {
     {"remainder", &remainder},
     //比较库：
     {"eq?", &eq},
+    {"eqv?", &eqv},
     {"equal?", &equal},
     {"not", &not_},
     {"=", &equal_num},
@@ -1229,4 +1612,42 @@ std::unordered_map<std::string, BuiltinProc> builtinProcs = {
     {"rank",&matrixRank},
     {"upper-triangle",&matrixUpperTriangle},
     {"inverse",&matrixInverse},
+    // 向量类库
+    {"vector?",&isVector},
+    {"make-vector",&makeVector},
+    {"vector",&vector},
+    {"vector-ref",&vectorRef},
+    {"vector-set!",&vectorSet},
+    {"vector-length",&vectorLength},
+    {"vector-fill!",&vectorFill},
+    {"vector->list",&vector2List},
+    {"list->vector",&list2Vector},
+    // 哈希表类库
+    {"hash-table?",&isHashTable},
+    {"make-hash-table",&makeHashTable},
+    {"hash-ref",&hashRef},
+    {"hash-set!",&hashSet},
+    {"hash-remove!",&hashRemove},
+    {"hash-count",&hashCount},
+    {"hash-keys",&hashKeys},
+    // future
+    {"future?",&isFuture},
+    {"touch",&touch},
+    // 承诺与流
+    {"force",&forceProc},
+    {"make-promise",&makePromise},
+    {"promise?",&isPromise},
+    {"stream-car",&streamCar},
+    {"stream-cdr",&streamCdr},
+    {"stream-null?",&isNull},
+    {"stream-take",&streamTake},
+    // 通道
+    {"channel?",&isChannel},
+    {"make-channel",&makeChannel},
+    {"channel-send",&channelSend},
+    {"channel-try-send",&channelTrySend},
+    {"channel-recv",&channelRecv},
+    {"channel-close",&channelClose},
+    // 运行时统计
+    {"runtime-stats",&runtimeStats},
 };
\ No newline at end of file
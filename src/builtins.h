@@ -3,6 +3,8 @@
 
 #include "./rational.h"
 #include "./matrix.h"
+#include "./hash_table.h"
+#include "./vector_value.h"
 #include "./value.h"
 #include <iostream>
 #include <unordered_map>
@@ -10,16 +12,18 @@
 
 typedef ValuePtr (*BuiltinProc)(const std::vector<ValuePtr>&);
 
-extern std::unordered_map<std::string, BuiltinProc> builtinProcs;
+extern const std::unordered_map<std::string, BuiltinProc> builtinProcs;
 
 // 辅助函数
 MatrixValue IdentityMatrix(int n);
+bool isEqv(const ValuePtr& lhs, const ValuePtr& rhs);
+bool isEqual(const ValuePtr& lhs, const ValuePtr& rhs);
 
 //  以下为课程要求内置过程
 ValuePtr display(const std::vector<ValuePtr>& args);
 ValuePtr displayln(const std::vector<ValuePtr>& args);
-ValuePtr exitProcedure(const std::vector<ValuePtr>& args);
-ValuePtr error(const std::vector<ValuePtr>& args);
+[[noreturn]] ValuePtr exitProcedure(const std::vector<ValuePtr>& args);
+[[noreturn]] ValuePtr error(const std::vector<ValuePtr>& args);
 ValuePtr newline(const std::vector<ValuePtr>& args);
 ValuePtr print(const std::vector<ValuePtr>& args);
 ValuePtr isAtom(const std::vector<ValuePtr>& args);
@@ -36,6 +40,8 @@ ValuePtr append(const std::vector<ValuePtr>& args);
 ValuePtr car(const std::vector<ValuePtr>& args);
 ValuePtr cdr(const std::vector<ValuePtr>& args);
 ValuePtr cons(const std::vector<ValuePtr>& args);
+ValuePtr setCar(const std::vector<ValuePtr>& args);
+ValuePtr setCdr(const std::vector<ValuePtr>& args);
 ValuePtr length(const std::vector<ValuePtr>& args);
 ValuePtr list(const std::vector<ValuePtr>& args);
 ValuePtr add(const std::vector<ValuePtr>& params);
@@ -49,6 +55,7 @@ ValuePtr quotient(const std::vector<ValuePtr>& params);
 ValuePtr modulo(const std::vector<ValuePtr>& params);
 ValuePtr remainder(const std::vector<ValuePtr>& params);
 ValuePtr eq(const std::vector<ValuePtr>& params);
+ValuePtr eqv(const std::vector<ValuePtr>& params);
 ValuePtr equal(const std::vector<ValuePtr>& params);
 ValuePtr equal_num(const std::vector<ValuePtr>& params);
 ValuePtr not_(const std::vector<ValuePtr>& params);
@@ -95,4 +102,38 @@ ValuePtr matrixRank(const std::vector<ValuePtr>& params);
 ValuePtr matrixUpperTriangle(const std::vector<ValuePtr>& params);
 ValuePtr matrixInverse(const std::vector<ValuePtr>& params);
 
+// 向量类库
+ValuePtr isVector(const std::vector<ValuePtr>& params);
+ValuePtr makeVector(const std::vector<ValuePtr>& params);
+ValuePtr vector(const std::vector<ValuePtr>& params);
+ValuePtr vectorRef(const std::vector<ValuePtr>& params);
+ValuePtr vectorSet(const std::vector<ValuePtr>& params);
+ValuePtr vectorLength(const std::vector<ValuePtr>& params);
+ValuePtr vectorFill(const std::vector<ValuePtr>& params);
+ValuePtr vector2List(const std::vector<ValuePtr>& params);
+ValuePtr list2Vector(const std::vector<ValuePtr>& params);
+
+// 哈希表类库
+ValuePtr isHashTable(const std::vector<ValuePtr>& params);
+ValuePtr makeHashTable(const std::vector<ValuePtr>& params);
+ValuePtr hashRef(const std::vector<ValuePtr>& params);
+ValuePtr hashSet(const std::vector<ValuePtr>& params);
+ValuePtr hashRemove(const std::vector<ValuePtr>& params);
+ValuePtr hashCount(const std::vector<ValuePtr>& params);
+ValuePtr hashKeys(const std::vector<ValuePtr>& params);
+
+// future
+ValuePtr isFuture(const std::vector<ValuePtr>& params);
+ValuePtr touch(const std::vector<ValuePtr>& params);
+
+// 通道
+ValuePtr isChannel(const std::vector<ValuePtr>& params);
+ValuePtr makeChannel(const std::vector<ValuePtr>& params);
+ValuePtr channelSend(const std::vector<ValuePtr>& params);
+ValuePtr channelRecv(const std::vector<ValuePtr>& params);
+ValuePtr channelClose(const std::vector<ValuePtr>& params);
+
+// 运行时统计
+ValuePtr runtimeStats(const std::vector<ValuePtr>& params);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "./channel.h"
+#include "./error.h"
+
+#include <bit>
+
+ChannelValue::ChannelValue(std::size_t capacity) : vacancies(capacity) {
+    // 缓冲区大小取不小于容量与 2 的 2 的幂，下标用掩码求余
+    auto size = std::bit_ceil(std::max<std::size_t>(capacity, 2));
+    cells = std::make_unique<Cell[]>(size);
+    mask = size - 1;
+    for (std::size_t i = 0; i < size; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool ChannelValue::tryReserve() {
+    auto free = vacancies.load(std::memory_order_relaxed);
+    while (free > 0) {
+        if (vacancies.compare_exchange_weak(free, free - 1, std::memory_order_acquire)) return true;
+    }
+    return false;
+}
+
+// 已占用空位后写入。缓冲区不会真正满，但取走前一轮值的消费者可能还没交还槽位，此时等它交还
+void ChannelValue::push(ValuePtr& value) {
+    while (true) {
+        auto seen = events.load(std::memory_order_acquire);
+        if (tryPush(value)) {
+            signal();
+            return;
+        }
+        events.wait(seen, std::memory_order_acquire);
+    }
+}
+
+bool ChannelValue::tryPush(ValuePtr& value) {
+    auto pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        auto& cell = cells[pos & mask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.data = std::move(value);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // 缓冲区已满
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ChannelValue::tryPop(ValuePtr& value) {
+    auto pos = dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        auto& cell = cells[pos & mask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                value = std::move(cell.data);
+                cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // 缓冲区为空
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ChannelValue::signal() {
+    events.fetch_add(1, std::memory_order_release);
+    events.notify_all();
+}
+
+void ChannelValue::send(ValuePtr value) {
+    while (true) {
+        // 先记下事件计数再尝试，失败后等待期间若有收发或关闭会立即返回
+        auto seen = events.load(std::memory_order_acquire);
+        if (closed.load(std::memory_order_acquire)) throw LispError("channel-send: the channel is closed.");
+        if (tryReserve()) break;
+        events.wait(seen, std::memory_order_acquire);
+    }
+    push(value);
+}
+
+bool ChannelValue::trySend(ValuePtr value) {
+    if (closed.load(std::memory_order_acquire)) throw LispError("channel-send: the channel is closed.");
+    if (!tryReserve()) return false;
+    push(value);
+    return true;
+}
+
+std::optional<ValuePtr> ChannelValue::receive() {
+    ValuePtr value;
+    while (true) {
+        auto seen = events.load(std::memory_order_acquire);
+        if (tryPop(value)) {
+            vacancies.fetch_add(1, std::memory_order_release);
+            signal();
+            return value;
+        }
+        // 关闭前发出的值都要取完
+        if (closed.load(std::memory_order_acquire)) {
+            if (tryPop(value)) {
+                vacancies.fetch_add(1, std::memory_order_release);
+                signal();
+                return value;
+            }
+            return std::nullopt;
+        }
+        events.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void ChannelValue::close() {
+    closed.store(true, std::memory_order_release);
+    signal();
+}
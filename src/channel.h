@@ -0,0 +1,51 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "./value.h"
+
+// 有界通道：Vyukov 式无锁多生产者多消费者环形缓冲区。
+// 每个槽位带一个序号，生产者与消费者各自用 CAS 推进位置，槽位的序号表明它当前可写还是可读。
+// 环形缓冲区的大小取 2 的幂，可能大于请求的容量；容量由单独的空位计数限制，发送前先占用一个空位。
+// 缓冲区满或空时在 events 计数上等待，任何一次收发或关闭都会唤醒等待者。
+class ChannelValue : public Value {
+public:
+    explicit ChannelValue(std::size_t capacity);
+    std::string toString() const override { return "#<channel>"; }
+    bool isTransferable() const override { return false; }
+
+    // 通道已关闭时报错
+    void send(ValuePtr value);
+    // 不等待的发送，通道已满时返回 false
+    bool trySend(ValuePtr value);
+    // 通道已关闭且取空时返回空
+    std::optional<ValuePtr> receive();
+    void close();
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        ValuePtr data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> vacancies;
+    alignas(64) std::atomic<std::size_t> enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> dequeuePos{0};
+    alignas(64) std::atomic<std::uint32_t> events{0};
+    std::atomic<bool> closed{false};
+
+    bool tryReserve();
+    void push(ValuePtr& value);
+    bool tryPush(ValuePtr& value);
+    bool tryPop(ValuePtr& value);
+    void signal();
+};
+
+#endif
@@ -1,107 +1,441 @@
 #include "./eval_env.h"
 #include "./error.h"
 #include "./forms.h"
+#include "./future.h"
+#include "./isolate.h"
+#include "./optimizer.h"
+#include "./eval_limits.h"
+#include "./promise.h"
+#include "./parallel.h"
+#include "./profiler.h"
+#include "./stats.h"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iterator>
 
-EvalEnv::EvalEnv() : parent(nullptr) {
+// 排序元素。比较过程为内置的 < 或 > 且元素都是数时，先取出数值再直接比较，
+// 不再逐次经 apply 回调；否则调用比较过程。stable 为假时允许使用不稳定的内省排序。
+static void sortValues(std::vector<ValuePtr>& values, const ValuePtr& proc, EvalEnv& env, bool stable){
+    auto builtin = dynamic_cast<const BuiltinProcValue*>(proc.get());
+    bool ascending = builtin && builtin->getName() == "<";
+    bool descending = builtin && builtin->getName() == ">";
+    if(ascending || descending){
+        std::vector<std::pair<double, std::size_t>> keys;
+        keys.reserve(values.size());
+        for(std::size_t i = 0; i < values.size(); i++){
+            // NaN 不满足严格弱序，交给通用路径处理
+            if(!values[i]->isNumber() || std::isnan(values[i]->asNumber())) break;
+            keys.emplace_back(values[i]->asNumber(), i);
+        }
+        if(keys.size() == values.size()){
+            auto compare = [descending](const auto& a, const auto& b){
+                return descending ? a.first > b.first : a.first < b.first;
+            };
+            if(stable){
+                std::stable_sort(keys.begin(), keys.end(), compare);
+            } else {
+                std::sort(keys.begin(), keys.end(), compare);
+            }
+            std::vector<ValuePtr> sorted;
+            sorted.reserve(values.size());
+            for(const auto& key : keys) sorted.push_back(std::move(values[key.second]));
+            values = std::move(sorted);
+            return;
+        }
+    }
+    // 用户比较过程可能不满足严格弱序，归并排序在这种情况下也不会越界
+    std::vector<ValuePtr> args(2);
+    std::stable_sort(values.begin(), values.end(), [&](const ValuePtr& a, const ValuePtr& b){
+        args[0] = a;
+        args[1] = b;
+        return env.apply(proc, args)->asBool();
+    });
+}
+
+// 同步遍历 params[from..] 中的各个列表：每轮把各列表的当前元素放进同一个实参缓冲区再调用 f，
+// 任一列表走到末尾即停止。缓冲区开头留出 lead 个位置供 f 自行填写。
+// 各列表同步前进，共用一套 Brent 环检测的步数；只有全部列表都带环时才不会停止，此时报错。
+template <typename F>
+static void forEachAcross(const std::vector<ValuePtr>& params, std::size_t from, F&& f, std::size_t lead = 0){
+    std::vector<ValuePtr> cursors(params.begin() + from, params.end());
+    std::vector<ValuePtr> args(lead + cursors.size());
+    std::vector<ValuePtr> marks(cursors);
+    std::vector<bool> cyclic(cursors.size(), false);
+    std::size_t cyclicCount = 0, power = 1, steps = 0;
+    while(std::all_of(cursors.begin(), cursors.end(), [](const ValuePtr& cursor){ return cursor->isPair(); })){
+        for(std::size_t i = 0; i < cursors.size(); i++){
+            const auto& pair = static_cast<const PairValue&>(*cursors[i]);
+            args[lead + i] = pair.getCar();
+            cursors[i] = pair.getCdr();
+            if(!cyclic[i] && cursors[i] == marks[i]){
+                cyclic[i] = true;
+                if(++cyclicCount == cursors.size()) throw LispError("Expected a proper list, got a cyclic one.");
+            }
+        }
+        f(args);
+        if(++steps == power){
+            marks = cursors;
+            power *= 2;
+            steps = 0;
+        }
+    }
+}
+
+namespace {
+
+// 当前线程正在执行的任务，不在任务中时为 0
+thread_local std::uint64_t currentTask = 0;
+std::atomic<std::uint64_t> nextTask{1};
+
+}  // namespace
+
+std::atomic<long> runningFutures{0};
+
+namespace {
+
+constexpr std::size_t VALUE_LOCKS = 64;
+std::shared_mutex valueLocks[VALUE_LOCKS];
+
+std::shared_mutex& valueLock(const Value& value) {
+    return valueLocks[std::hash<const Value*>{}(&value) / alignof(std::max_align_t) % VALUE_LOCKS];
+}
+
+bool sharingValues() {
+    return currentTask || runningFutures.load(std::memory_order_acquire) > 0;
+}
+
+}  // namespace
+
+ValueReadLock::ValueReadLock(const Value& value) : lock(valueLock(value), std::defer_lock) {
+    if (sharingValues()) lock.lock();
+}
+
+ValueWriteLock::ValueWriteLock(const Value& value) : lock(valueLock(value), std::defer_lock) {
+    if (sharingValues()) lock.lock();
+}
+
+TaskScope::TaskScope() : previous(currentTask) {
+    currentTask = nextTask.fetch_add(1, std::memory_order_relaxed);
+}
+
+TaskScope::~TaskScope() {
+    currentTask = previous;
+}
+
+// (pmap proc list [chunk-size])：把列表按块分给线程池，每块顺序调用 proc，结果按原顺序放回。
+// 每块是一个任务，只能修改过程调用新建的环境，修改共享的绑定时报错。
+static std::vector<ValuePtr> parallelApply(const std::vector<ValuePtr>& params, EvalEnv& env,
+                                           const std::string& name, bool collect){
+    if(params.size() != 2 && params.size() != 3) throw LispError(name + " takes 2 or 3 arguments");
+    if(!params[0]->isProcedure()) throw LispError(name + " expects a procedure as its first argument");
+    if(!params[1]->isPair() && !params[1]->isNil()) throw LispError(name + " expects a list");
+    std::vector<ValuePtr> elements;
+    forEachInList(params[1], [&](const ValuePtr& value) { elements.push_back(value); });
+    std::size_t chunk = 0;
+    if(params.size() == 3){
+        if(!params[2]->isNumber() || params[2]->asNumber() < 1) throw LispError(name + " expects a positive chunk size");
+        chunk = static_cast<std::size_t>(params[2]->asNumber());
+    } else {
+        // 缺省每个线程分到约四块，兼顾负载均衡与调度开销
+        chunk = std::max<std::size_t>(1, elements.size() / (defaultPool().size() * 4));
+    }
+    std::vector<ValuePtr> results(collect ? elements.size() : 0);
+    auto chunks = (elements.size() + chunk - 1) / chunk;
+    parallelFor(chunks, [&](std::size_t index) {
+        TaskScope scope;
+        std::vector<ValuePtr> arg(1);
+        auto end = std::min(elements.size(), (index + 1) * chunk);
+        for(auto i = index * chunk; i < end; i++){
+            arg[0] = elements[i];
+            auto result = env.apply(params[0], arg);
+            if(collect) results[i] = std::move(result);
+        }
+    });
+    return results;
+}
+
+EvalEnv::EvalEnv(std::shared_ptr<EvalEnv> parent) : parent(std::move(parent)), task(currentTask) {}
+
+EvalEnv::EvalEnv() : parent(nullptr), task(currentTask) {
     // 循环遍历 builtinProcs 并将所有的内置过程添加到符号表中
     for (const auto& proc : builtinProcs) {
-        symbolTable[proc.first] = std::make_shared<BuiltinProcValue>(proc.second);                
+        symbolTable[proc.first] = std::make_shared<BuiltinProcValue>(proc.second, proc.first);                
     }
     //特殊内置过程
     this->defineBinding(
         "eval",
         std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
-                                                return this->eval(params[0]);})
+                                                return this->eval(params[0]);}, "eval")
     );
     this->defineBinding(
         "apply",
         std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
                                                 auto a=params[1];
-                                                return this->apply(params[0],a->toVector());})
+                                                return this->apply(params[0],a->toVector());}, "apply")
     );    
     this->defineBinding(
         "map",
         std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
-                                                if(params.size() != 2) throw LispError("map takes 2 arguments");
+                                                if(params.size() < 2) throw LispError("map takes at least 2 arguments");
                                                 std::vector<ValuePtr> result;
-                                                auto proc = params[0];
-                                                auto values = params[1]->toVector();
-                                                if(proc->isPair()){
-                                                    throw LispError("Unimplemented, waiting for complement");
-                                                } else {
-                                                    for(int i = 0; i < values.size(); i++){
-                                                        std::vector<ValuePtr> arg{values[i]};
-                                                        result.emplace_back(this->apply(proc,arg));
+                                                if(params.size() == 2 && params[1]->isVector()){
+                                                    // 对向量映射得到等长的新向量；先取快照，调用过程时不持有锁
+                                                    std::vector<ValuePtr> elements;
+                                                    {
+                                                        ValueReadLock lock(*params[1]);
+                                                        elements = static_cast<const VectorValue&>(*params[1]).getElements();
+                                                    }
+                                                    std::vector<ValuePtr> arg(1);
+                                                    for(const auto& value : elements){
+                                                        arg[0] = value;
+                                                        result.emplace_back(this->apply(params[0], arg));
                                                     }
-                                                    return list(result);
+                                                    return ValuePtr(std::make_shared<VectorValue>(std::move(result)));
                                                 }
-        })
+                                                forEachAcross(params, 1, [&](const std::vector<ValuePtr>& args) {
+                                                    result.emplace_back(this->apply(params[0], args));
+                                                });
+                                                return list(result);
+        }, "map")
+    );
+    this->defineBinding(
+        "for-each",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
+                                                if(params.size() < 2) throw LispError("for-each takes at least 2 arguments");
+                                                forEachAcross(params, 1, [&](const std::vector<ValuePtr>& args) {
+                                                    this->apply(params[0], args);
+                                                });
+                                                return ValuePtr(std::make_shared<NilValue>());
+        }, "for-each")
     );
     this->defineBinding(
         "filter",
         std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
                                                 if(params.size() != 2) throw LispError("filter takes 2 arguments");
                                                 std::vector<ValuePtr> result;
-                                                auto proc = params[0];
-                                                auto values = params[1]->toVector();
-                                                if(proc->isPair()){
-                                                    throw LispError("Unimplemented, waiting for complement");
-                                                } else {
-                                                    for(int i = 0; i < values.size(); i++){
-                                                        if(this->apply(proc,{values[i]})->asBool()){
-                                                            std::vector<ValuePtr> arg{values[i]};
-                                                            result.emplace_back(values[i]);
-                                                        }
+                                                std::vector<ValuePtr> arg(1);
+                                                forEachInList(params[1], [&](const ValuePtr& value) {
+                                                    arg[0] = value;
+                                                    if(this->apply(params[0], arg)->asBool()){
+                                                        result.emplace_back(value);
                                                     }
-                                                    return list(result);
+                                                });
+                                                return list(result);
+        }, "filter")
+    );
+    this->defineBinding(
+        "fold-left",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
+                                                // (fold-left proc init list ...)：acc = (proc acc x ...)
+                                                if(params.size() < 3) throw LispError("fold-left takes at least 3 arguments");
+                                                ValuePtr acc = params[1];
+                                                forEachAcross(params, 2, [&](std::vector<ValuePtr>& args) {
+                                                    args[0] = std::move(acc);
+                                                    acc = this->apply(params[0], args);
+                                                }, 1);
+                                                return acc;
+        }, "fold-left")
+    );
+    this->defineBinding(
+        "fold-right",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
+                                                // (fold-right proc init list ...)：自右向左 acc = (proc x ... acc)
+                                                if(params.size() < 3) throw LispError("fold-right takes at least 3 arguments");
+                                                auto lists = params.size() - 2;
+                                                std::vector<ValuePtr> elements;
+                                                forEachAcross(params, 2, [&](const std::vector<ValuePtr>& args) {
+                                                    elements.insert(elements.end(), args.begin(), args.end());
+                                                });
+                                                ValuePtr acc = params[1];
+                                                std::vector<ValuePtr> args(lists + 1);
+                                                for(auto i = elements.size(); i > 0; i -= lists){
+                                                    std::copy(elements.begin() + (i - lists), elements.begin() + i, args.begin());
+                                                    args[lists] = acc;
+                                                    acc = this->apply(params[0], args);
                                                 }
-        })
+                                                return acc;
+        }, "fold-right")
     );
     this->defineBinding(
         "reduce",
         std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params){
                                                 if(params.size() != 2) throw LispError("reduce takes 2 arguments");
                                                 if(params[1]->isNil()) throw LispError("Cannot reduce nilvalue!");
-                                                
-                                                if(params[1]->toVector().size() == 1) return params[1]->toVector()[0];
-                                                else {
-                                                    auto proc = params[0];
-                                                    auto p = params[1]->toVector();
-                                                    auto v = *p.rbegin();
-                                                    for (int i = p.size() - 2; i >= 0; i--) {
-                                                        std::vector<ValuePtr> args{p[i], v};
-                                                        v = this->apply(proc, args);
-                                                    }        
-                                                    return v;
+                                                // 右结合归约需要倒序访问，只收集一次元素
+                                                auto proc = params[0];
+                                                auto p = params[1]->toVector();
+                                                if(p.empty()) throw LispError("reduce expects a list");
+                                                auto v = *p.rbegin();
+                                                std::vector<ValuePtr> args(2);
+                                                for (int i = p.size() - 2; i >= 0; i--) {
+                                                    args[0] = p[i];
+                                                    args[1] = v;
+                                                    v = this->apply(proc, args);
+                                                }        
+                                                return v;
+        }, "reduce")
+    );
+    this->defineBinding(
+        "pmap",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
+                                                return list(parallelApply(params, *this, "pmap", true));
+        }, "pmap")
+    );
+    this->defineBinding(
+        "parallel-for-each",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
+                                                parallelApply(params, *this, "parallel-for-each", false);
+                                                return ValuePtr(std::make_shared<NilValue>());
+        }, "parallel-for-each")
+    );
+    this->defineBinding(
+        "spawn",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params) {
+                                                // 在新线程上调用过程，返回可用 touch 等待的 future
+                                                if(params.empty() || !params[0]->isProcedure()) throw LispError("spawn expects a procedure");
+                                                std::vector<ValuePtr> args(params.begin() + 1, params.end());
+                                                auto env = this->shared_from_this();
+                                                return ValuePtr(std::make_shared<FutureValue>([env, proc = params[0], args] {
+                                                    return env->apply(proc, args);
+                                                }, true));
+        }, "spawn")
+    );
+    // isolate 过程需要所在的全局环境来复制值，流过程需要调用过程参数
+    for (auto [name, proc] : {std::pair{"isolate-spawn", &isolateSpawn}, std::pair{"isolate-send", &isolateSend},
+                              std::pair{"isolate-receive", &isolateReceive}, std::pair{"isolate-join", &isolateJoin},
+                              std::pair{"stream-map", &streamMap}, std::pair{"stream-filter", &streamFilter}}) {
+        this->defineBinding(
+            name,
+            std::make_shared<BuiltinProcValue>([this, proc](const std::vector<ValuePtr>& params) {
+                                                    return proc(params, *this);
+            }, name)
+        );
+    }
+    this->defineBinding("the-empty-stream", std::make_shared<NilValue>());
+    this->defineBinding(
+        "sort",
+        std::make_shared<BuiltinProcValue>([this](const std::vector<ValuePtr>& params){
+                                                if(params.size() != 2) throw LispError("sort takes 2 arguments");
+                                                if(!params[1]->isProcedure()) throw LispError("sort expects a procedure as its second argument");
+                                                if(params[0]->isVector()){
+                                                    // 向量排序返回新向量，原向量不变
+                                                    std::vector<ValuePtr> elements;
+                                                    {
+                                                        ValueReadLock lock(*params[0]);
+                                                        elements = static_cast<const VectorValue&>(*params[0]).getElements();
+                                                    }
+                                                    sortValues(elements, params[1], *this, false);
+                                                    return ValuePtr(std::make_shared<VectorValue>(std::move(elements)));
                                                 }
-        })
+                                                if(!params[0]->isPair() && !params[0]->isNil()) throw LispError("sort expects a list or a vector");
+                                                std::vector<ValuePtr> elements;
+                                                forEachInList(params[0], [&](const ValuePtr& value) { elements.push_back(value); });
+                                                sortValues(elements, params[1], *this, true);
+                                                return list(elements);
+        }, "sort")
     );
 }
 
 std::shared_ptr<EvalEnv> EvalEnv::createChild(const std::vector<std::string>& params, const std::vector<ValuePtr>& args){
     if (args.size() != params.size()) throw LispError("arguments not matched");
-    std::shared_ptr<EvalEnv> child{new EvalEnv};
-    child->symbolTable.clear();
-    child->parent = this->shared_from_this();
-    for(int i = 0; i < params.size(); i++){
-        child->defineBinding(params[i], args[i]);
+    countStat(STAT_FRAMES);
+    std::shared_ptr<EvalEnv> child{new EvalEnv(this->shared_from_this())};
+    child->symbolTable.reserve(params.size());
+    for(std::size_t i = 0; i < params.size(); i++){
+        // 新环境只有当前线程可见，也不在任何已有闭包的环境链上，直接写入
+        child->symbolTable[params[i]] = args[i];
     }
     return child;
 }
 
+// 只有创建环境的任务能修改它，所以它自己读取时无需加锁
+bool EvalEnv::lockReads() const {
+    return (task || runningFutures.load(std::memory_order_acquire) > 0) &&
+           (task != currentTask || owner != std::this_thread::get_id());
+}
+
+bool EvalEnv::lockWrites() const {
+    return currentTask || runningFutures.load(std::memory_order_acquire) > 0;
+}
+
+ValuePtr EvalEnv::findLocal(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (lockReads()) lock.lock();
+    auto it = symbolTable.find(name);
+    return it != symbolTable.end() ? it->second : nullptr;
+}
+
+std::unordered_map<std::string, ValuePtr> EvalEnv::getBindings() const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (lockReads()) lock.lock();
+    return symbolTable;
+}
+
+void EvalEnv::checkOwner(const std::string& name) const {
+    if (task != currentTask) {
+        throw LispError("Cannot modify " + name + (currentTask ? " inside a pmap or future body."
+                                                               : " outside the pmap or future body that created it."));
+    }
+    if (owner != std::this_thread::get_id()) {
+        throw LispError("Cannot modify " + name + " from another thread.");
+    }
+}
+
 void EvalEnv::defineBinding(const std::string& name, ValuePtr value) {
-    symbolTable[name] = value;
+    checkOwner(name);
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (lockWrites()) lock.lock();
+    symbolTable[name] = std::move(value);
+    // 先写入再使折叠失效：看到新版本号的折叠一定也看到新绑定
+    invalidateFolding(name);
 }
 
+void EvalEnv::bindLocal(const std::string& name, ValuePtr value) {
+    checkOwner(name);
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (lockWrites()) lock.lock();
+    symbolTable[name] = std::move(value);
+}
+
+std::vector<ValuePtr*> EvalEnv::localSlots(const std::vector<std::string>& names) {
+    // 环境中的绑定只增不删，元素的地址在插入新绑定、重新散列后仍然有效
+    std::vector<ValuePtr*> slots;
+    slots.reserve(names.size());
+    for (const auto& name : names) slots.push_back(&symbolTable[name]);
+    return slots;
+}
+
+void EvalEnv::setBinding(const std::string& name, ValuePtr value) {
+    for (EvalEnv* env = this; env; env = env->parent.get()) {
+        if (!env->findLocal(name)) continue;
+        // 通过检查后只有当前任务能修改该环境，查找与赋值之间绑定不会消失
+        env->checkOwner(name);
+        std::unique_lock<std::shared_mutex> lock(env->mutex, std::defer_lock);
+        if (env->lockWrites()) lock.lock();
+        env->symbolTable[name] = std::move(value);
+        invalidateFolding(name);
+        return;
+    }
+    throw LispError("Variable " + name + " not defined.");
+}
 
 ValuePtr EvalEnv::eval(ValuePtr expr) {
+    if (limiting) {
+        EvalGuard guard;
+        return evalExpr(std::move(expr));
+    }
+    return evalExpr(std::move(expr));
+}
+
+ValuePtr EvalEnv::evalExpr(ValuePtr expr) {
     if (expr->isSelfEvaluating()) {
+        countStat(STAT_EVAL_SELF_EVALUATING);
         return expr;
     } else if (expr->isNil()) {
         throw LispError("Evaluating nil is prohibited.");
     } else if (expr->asSymbol()) {
+        countStat(STAT_EVAL_SYMBOL);
         return evalSymbol(expr);
     } else if (expr->isPair()) { 
         return evalPair(expr);
@@ -111,14 +445,10 @@ ValuePtr EvalEnv::eval(ValuePtr expr) {
 }
 
 ValuePtr EvalEnv::lookupBinding(const std::string& name) {
-    auto it = symbolTable.find(name);
-    if (it != symbolTable.end()) {
-        return it->second;
-    } else if (parent) {
-        return parent->lookupBinding(name); // 递归查找
-    } else {
-        throw LispError("Variable " + name + " not defined.");
+    for (const EvalEnv* env = this; env; env = env->parent.get()) {
+        if (auto value = env->findLocal(name)) return value;
     }
+    throw LispError("Variable " + name + " not defined.");
 }
 ValuePtr EvalEnv::evalSymbol(ValuePtr expr){
     if(expr->asSymbol()){
@@ -129,29 +459,48 @@ ValuePtr EvalEnv::evalSymbol(ValuePtr expr){
 }
 
 ValuePtr EvalEnv::evalPair(ValuePtr expr){
-    auto list = expr->toVector();
-    while (list[0]->isPair()) list[0] = eval(list[0]);
-    if (auto name = list[0]->asSymbol()) {
-        if (SPECIAL_FORMS.contains(*name)) {
-            return SPECIAL_FORMS.at(*name)(expr->CDR()->toVector(), *this);
+    ValuePtr head = expr->CAR();
+    while (head->isPair()) head = eval(head);
+    if (auto name = head->asSymbol()) {
+        auto form = SPECIAL_FORMS.find(*name);
+        if (form != SPECIAL_FORMS.end()) {
+            countStat(STAT_EVAL_SPECIAL_FORM);
+            return form->second(expr->CDR()->toVector(), *this);
         } else {
-            ValuePtr proc = this->eval(list[0]);
+            countStat(STAT_EVAL_CALL);
+            ValuePtr proc = this->eval(head);
             std::vector<ValuePtr> args = evalList(expr->CDR());
             return this->apply(proc, args);  
         }
     } else {
-        ValuePtr proc = list[0];
+        countStat(STAT_EVAL_CALL);
+        ValuePtr proc = head;
         std::vector<ValuePtr> args = evalList(expr->CDR());
         return apply(proc, args);  
     }
 }
 
-ValuePtr EvalEnv::apply(ValuePtr proc, std::vector<ValuePtr> args){
+ValuePtr EvalEnv::apply(const ValuePtr& proc, const std::vector<ValuePtr>& args){
+    if (profiling) {
+        if (typeid(*proc) == typeid(BuiltinProcValue)) {
+            ProfileFrame frame(static_cast<const BuiltinProcValue&>(*proc).getName());
+            return applyProc(proc, args);
+        } else if (typeid(*proc) == typeid(LambdaValue)) {
+            ProfileFrame frame(static_cast<const LambdaValue&>(*proc).getName());
+            return applyProc(proc, args);
+        }
+    }
+    return applyProc(proc, args);
+}
+
+ValuePtr EvalEnv::applyProc(const ValuePtr& proc, const std::vector<ValuePtr>& args){
     if (typeid(*proc) == typeid(BuiltinProcValue)) {
         // 调用内置过程
-        return std::dynamic_pointer_cast<BuiltinProcValue>(proc)->getFunc()(args);
+        countStat(STAT_APPLY_BUILTIN);
+        return static_cast<const BuiltinProcValue&>(*proc).getFunc()(args);
     } else if (typeid(*proc) == typeid(LambdaValue)) {
-        return std::dynamic_pointer_cast<LambdaValue>(proc)->apply(args);
+        countStat(STAT_APPLY_LAMBDA);
+        return static_cast<const LambdaValue&>(*proc).apply(args);
     } else {
         throw LispError("Unimplemented");
     }
@@ -159,8 +508,6 @@ ValuePtr EvalEnv::apply(ValuePtr proc, std::vector<ValuePtr> args){
 
 std::vector<ValuePtr> EvalEnv::evalList(ValuePtr expr) {
     std::vector<ValuePtr> result;
-    std::ranges::transform(expr->toVector(),
-                           std::back_inserter(result),
-                           [this](ValuePtr v) { return this->eval(v); });
+    forEachInList(expr, [&](const ValuePtr& v) { result.push_back(this->eval(v)); });
     return result;
-}
\ No newline at end of file
+}
@@ -1,6 +1,11 @@
 #ifndef EVAL_ENV_H
 #define EVAL_ENV_H
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -10,21 +15,86 @@
 
 using namespace std::literals;
 
+// 线程模型：每个 isolate 拥有独立的全局环境，isolate 之间只通过复制传递值。
+// pmap 的每一块与每个 future 都是一个任务。环境记录创建它的任务，只能在同一任务中修改：
+// 任务中只能修改自己新建的环境，修改外层环境时总是报错，与由哪个线程执行无关。
+// 有 future 在运行时，创建环境的线程可能一边修改一边被 future 读取，此时读写绑定都加锁；
+// 任务中新建的环境可能被其他线程读取，其他线程读取时也加锁。
+// 对子、向量、哈希表与承诺可以在任务之间共享和修改，见 ValueReadLock。
 class EvalEnv : public std::enable_shared_from_this<EvalEnv>{
 public:
     EvalEnv();
     ValuePtr eval(ValuePtr expr);
     void defineBinding(const std::string& name, ValuePtr value);
-    ValuePtr apply(ValuePtr proc, std::vector<ValuePtr> args);
+    // 修改最近一层环境中已有的绑定，找不到时报错
+    void setBinding(const std::string& name, ValuePtr value);
+    // 在 let*、letrec 新建的环境中绑定名字。名字或已在本层占位，或此前没有闭包能经由本层看到它，
+    // 已折叠的过程体对名字的解析不会改变，因此不使常量折叠失效
+    void bindLocal(const std::string& name, ValuePtr value);
+    // 本层中各名字绑定的位置，供原地执行的循环逐轮直接更新变量。
+    // 只用于循环自己新建、不会被闭包捕获的环境，写入时不加锁，也不使常量折叠失效
+    std::vector<ValuePtr*> localSlots(const std::vector<std::string>& names);
+    ValuePtr apply(const ValuePtr& proc, const std::vector<ValuePtr>& args);
     std::vector<ValuePtr> evalList(ValuePtr expr);
     ValuePtr lookupBinding(const std::string& name);
+    // 只在本层环境中查找，找不到时返回空指针
+    ValuePtr findLocal(const std::string& name) const;
     std::shared_ptr<EvalEnv> createChild(const std::vector<std::string>& params, const std::vector<ValuePtr>& args);
+    // 本层全部绑定的副本
+    std::unordered_map<std::string, ValuePtr> getBindings() const;
+    std::shared_ptr<EvalEnv> getParent() const { return parent; }
 private:
     std::unordered_map<std::string, ValuePtr> symbolTable;
     std::shared_ptr<EvalEnv> parent;
+    std::thread::id owner = std::this_thread::get_id();
+    std::uint64_t task;
+    mutable std::shared_mutex mutex;
 
+    // 子环境只需记录父环境，不必装入全部内置过程
+    explicit EvalEnv(std::shared_ptr<EvalEnv> parent);
+    void checkOwner(const std::string& name) const;
+    bool lockReads() const;
+    bool lockWrites() const;
+
+    ValuePtr evalExpr(ValuePtr expr);
     ValuePtr evalSymbol(ValuePtr expr);
     ValuePtr evalPair(ValuePtr expr);
+    ValuePtr applyProc(const ValuePtr& proc, const std::vector<ValuePtr>& args);
+};
+
+// 正在运行的 future 个数，创建时加一、计算结束时减一
+extern std::atomic<long> runningFutures;
+
+// 在当前线程上执行一个任务：作用域内新建的环境属于该任务
+class TaskScope {
+public:
+    TaskScope();
+    ~TaskScope();
+    TaskScope(const TaskScope&) = delete;
+    TaskScope& operator=(const TaskScope&) = delete;
+
+private:
+    std::uint64_t previous;
+};
+
+// 共享的可变值的锁。有任务或 future 在运行时，car、cdr、vector-ref、hash-ref 等单次读取加读锁，
+// set-car!、vector-set!、hash-set! 等单次修改加写锁，并发修改同一个值不会丢失或损坏。
+// 锁按对象地址分配到固定数量的读写锁上，每次只持有一把，不会死锁。
+// 遍历整个结构的操作（equal?、打印、length 等）不加锁。
+class ValueReadLock {
+public:
+    explicit ValueReadLock(const Value& value);
+
+private:
+    std::shared_lock<std::shared_mutex> lock;
+};
+
+class ValueWriteLock {
+public:
+    explicit ValueWriteLock(const Value& value);
+
+private:
+    std::unique_lock<std::shared_mutex> lock;
 };
 
 using SpecialFormType = std::shared_ptr<Value>(const std::vector<ValuePtr>&, EvalEnv&);
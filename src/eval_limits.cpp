@@ -0,0 +1,58 @@
+#include "./eval_limits.h"
+#include "./error.h"
+#include "./stats.h"
+
+#include <atomic>
+#include <string>
+
+bool limiting = false;
+
+namespace {
+
+std::uint64_t maxSteps = 0;
+std::uint64_t maxDepth = 0;
+std::int64_t maxHeap = 0;
+
+std::atomic<std::uint64_t> steps{0};
+thread_local std::uint64_t depth = 0;
+
+}  // namespace
+
+void setStepLimit(std::uint64_t value) {
+    maxSteps = value;
+    limiting = limiting || value;
+}
+
+void setDepthLimit(std::uint64_t value) {
+    maxDepth = value;
+    limiting = limiting || value;
+}
+
+void setHeapLimit(std::int64_t value) {
+    maxHeap = value;
+    if (value) {
+        limiting = true;
+        if (!collectingStats) startStats(false);
+    }
+}
+
+void resetStepBudget() {
+    steps.store(0, std::memory_order_relaxed);
+}
+
+EvalGuard::EvalGuard() {
+    if (maxSteps && steps.fetch_add(1, std::memory_order_relaxed) >= maxSteps) {
+        throw LispError("Evaluation step limit exceeded (" + std::to_string(maxSteps) + " steps).");
+    }
+    if (maxHeap && liveBytes() > maxHeap) {
+        throw LispError("Heap limit exceeded (" + std::to_string(maxHeap) + " bytes).");
+    }
+    if (maxDepth && depth >= maxDepth) {
+        throw LispError("Maximum recursion depth exceeded (" + std::to_string(maxDepth) + ").");
+    }
+    depth++;
+}
+
+EvalGuard::~EvalGuard() {
+    depth--;
+}
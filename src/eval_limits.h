@@ -0,0 +1,30 @@
+#ifndef EVAL_LIMITS_H
+#define EVAL_LIMITS_H
+
+#include <cstdint>
+
+// 沙箱运行的资源限制（--max-steps / --max-depth / --max-heap）。
+// 任一限制开启后，EvalEnv::eval 每次求值都经过 EvalGuard：累计步数、记录嵌套深度并检查存活堆内存，
+// 超出时抛出 LispError，可以像其他错误一样被捕获。步数为全部线程共用的预算，深度按线程分别计算。
+// 文件模式下步数预算覆盖整个脚本；REPL 中每个顶层表达式重新开始计数。
+
+// 是否开启了任一限制；未开启时 eval 只多一次判断。须在创建线程之前设置
+extern bool limiting;
+
+// 参数为 0 表示不限制
+void setStepLimit(std::uint64_t steps);
+void setDepthLimit(std::uint64_t depth);
+// 堆内存按 operator new 统计的存活字节数计算，开启时一并开启运行时统计
+void setHeapLimit(std::int64_t bytes);
+// 重新开始计算步数，REPL 在求值每个顶层表达式之前调用
+void resetStepBudget();
+
+class EvalGuard {
+public:
+    EvalGuard();
+    ~EvalGuard();
+    EvalGuard(const EvalGuard&) = delete;
+    EvalGuard& operator=(const EvalGuard&) = delete;
+};
+
+#endif
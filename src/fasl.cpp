@@ -0,0 +1,305 @@
+#include "./fasl.h"
+#include "./error.h"
+#include "./vector_value.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <typeinfo>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char FASL_MAGIC[8] = {'M', 'L', 'F', 'A', 'S', 'L', '0', '2'};
+// 以本机字节序写入，读取时据此拒绝其他字节序生成的缓存
+constexpr std::uint32_t FASL_BYTE_ORDER = 0x01020304;
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            begin = static_cast<const char*>(addr);
+            length = st.st_size;
+            opened = true;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return;
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    begin = buffer.data();
+    length = buffer.size();
+    opened = true;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (opened) ::munmap(const_cast<char*>(begin), length);
+#endif
+}
+
+void FaslWriter::writeU8(std::uint8_t value) {
+    body.push_back(static_cast<char>(value));
+}
+
+void FaslWriter::writeU32(std::uint32_t value) {
+    body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void FaslWriter::writeU64(std::uint64_t value) {
+    body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void FaslWriter::writeDouble(double value) {
+    body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void FaslWriter::writeBytes(const std::string& bytes) {
+    writeU32(static_cast<std::uint32_t>(bytes.size()));
+    body += bytes;
+}
+
+void FaslWriter::writeValue(const ValuePtr& value) {
+    const auto& type = typeid(*value);
+    if (isReference(*value)) {
+        writeExtended(value);
+    } else if (type == typeid(NilValue)) {
+        writeU8(FASL_NIL);
+    } else if (type == typeid(BooleanValue)) {
+        writeU8(value->asBool() ? FASL_TRUE : FASL_FALSE);
+    } else if (type == typeid(NumericValue)) {
+        writeU8(FASL_NUMBER);
+        writeDouble(value->asNumber());
+    } else if (type == typeid(StringValue)) {
+        writeU8(FASL_STRING);
+        writeBytes(value->asString());
+    } else if (type == typeid(SymbolValue)) {
+        auto name = *value->asSymbol();
+        auto [it, inserted] = symbolIndex.try_emplace(name, static_cast<std::uint32_t>(symbols.size()));
+        if (inserted) symbols.push_back(name);
+        writeU8(FASL_SYMBOL);
+        writeU32(it->second);
+    } else if (type == typeid(PairValue)) {
+        // 列表按“元素个数 + 各元素 + 末尾”展开，避免沿 cdr 方向递归；
+        // 慢指针每两步前进一次，追上说明 cdr 方向带环
+        if (!expanding.insert(value.get()).second) throw LispError("Cannot serialize a cyclic structure");
+        std::vector<ValuePtr> elements;
+        ValuePtr current = value;
+        const Value* slow = value.get();
+        do {
+            elements.push_back(current->CAR());
+            current = current->CDR();
+            if (elements.size() % 2 == 0) slow = static_cast<const PairValue*>(slow)->getCdr().get();
+            if (current.get() == slow) throw LispError("Cannot serialize a cyclic structure");
+        } while (typeid(*current) == typeid(PairValue) && !isReference(*current));
+        writeU8(FASL_LIST);
+        writeU32(static_cast<std::uint32_t>(elements.size()));
+        for (const auto& element : elements) writeValue(element);
+        writeValue(current);
+        expanding.erase(value.get());
+    } else if (type == typeid(VectorValue)) {
+        if (!expanding.insert(value.get()).second) throw LispError("Cannot serialize a cyclic structure");
+        const auto& elements = static_cast<const VectorValue&>(*value).getElements();
+        writeU8(FASL_VECTOR);
+        writeU32(static_cast<std::uint32_t>(elements.size()));
+        for (const auto& element : elements) writeValue(element);
+        expanding.erase(value.get());
+    } else {
+        writeExtended(value);
+    }
+}
+
+void FaslWriter::writeExtended(const ValuePtr& value) {
+    throw LispError("Cannot serialize value: " + value->toString());
+}
+
+std::string FaslWriter::finish() const {
+    FaslWriter table;
+    table.writeU32(static_cast<std::uint32_t>(symbols.size()));
+    for (const auto& name : symbols) table.writeBytes(name);
+    return table.body + body;
+}
+
+FaslReader::FaslReader(const char* begin, const char* end) : pos(begin), end(end) {}
+
+void FaslReader::require(std::size_t n) const {
+    if (static_cast<std::size_t>(end - pos) < n) {
+        throw FileError("Truncated fasl data");
+    }
+}
+
+std::uint8_t FaslReader::readU8() {
+    require(1);
+    return static_cast<std::uint8_t>(*pos++);
+}
+
+std::uint32_t FaslReader::readU32() {
+    std::uint32_t value;
+    require(sizeof(value));
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+std::uint64_t FaslReader::readU64() {
+    std::uint64_t value;
+    require(sizeof(value));
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+double FaslReader::readDouble() {
+    double value;
+    require(sizeof(value));
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+std::string FaslReader::readBytes() {
+    auto size = readU32();
+    require(size);
+    std::string result(pos, size);
+    pos += size;
+    return result;
+}
+
+std::uint32_t FaslReader::readCount(std::size_t minSize) {
+    auto count = readU32();
+    if (static_cast<std::size_t>(end - pos) / minSize < count) {
+        throw FileError("Corrupted fasl data: bad element count");
+    }
+    return count;
+}
+
+void FaslReader::readSymbolTable() {
+    auto count = readCount(sizeof(std::uint32_t));
+    symbols.clear();
+    symbols.reserve(count);
+    // 同名符号只构造一次，数据区中按下标共享
+    for (std::uint32_t i = 0; i < count; i++) {
+        symbols.push_back(std::make_shared<SymbolValue>(readBytes()));
+    }
+}
+
+ValuePtr FaslReader::readValue() {
+    auto tag = readU8();
+    switch (tag) {
+        case FASL_NIL: return std::make_shared<NilValue>();
+        case FASL_FALSE: return std::make_shared<BooleanValue>(false);
+        case FASL_TRUE: return std::make_shared<BooleanValue>(true);
+        case FASL_NUMBER: return std::make_shared<NumericValue>(readDouble());
+        case FASL_STRING: return std::make_shared<StringValue>(readBytes());
+        case FASL_SYMBOL: {
+            auto index = readU32();
+            if (index >= symbols.size()) throw FileError("Corrupted fasl symbol index");
+            return symbols[index];
+        }
+        case FASL_LIST: {
+            auto count = readCount();
+            std::vector<ValuePtr> elements;
+            elements.reserve(count);
+            for (std::uint32_t i = 0; i < count; i++) elements.push_back(readValue());
+            return makeList(elements.begin(), elements.end(), readValue());
+        }
+        case FASL_VECTOR: {
+            std::vector<ValuePtr> elements(readCount());
+            for (auto& element : elements) element = readValue();
+            return std::make_shared<VectorValue>(std::move(elements));
+        }
+        default: return readExtended(tag);
+    }
+}
+
+ValuePtr FaslReader::readExtended(std::uint8_t tag) {
+    throw FileError("Corrupted fasl data: unknown tag " + std::to_string(tag));
+}
+
+FaslKey makeFaslKey(const std::string& filename, const std::string& source) {
+    FaslKey key;
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(filename, ec);
+    if (!ec) key.mtime = time.time_since_epoch().count();
+    key.size = source.size();
+    // FNV-1a 64 位哈希
+    key.hash = 14695981039346656037ull;
+    for (unsigned char c : source) {
+        key.hash ^= c;
+        key.hash *= 1099511628211ull;
+    }
+    return key;
+}
+
+std::string faslPath(const std::string& filename) {
+    return filename + ".fasl";
+}
+
+std::optional<std::vector<ValuePtr>> readFasl(const std::string& path, const FaslKey& key) {
+    MappedFile file(path);
+    if (!file.isOpen()) return std::nullopt;
+    try {
+        FaslReader reader(file.data(), file.data() + file.size());
+        char magic[sizeof(FASL_MAGIC)];
+        for (auto& c : magic) c = static_cast<char>(reader.readU8());
+        if (std::memcmp(magic, FASL_MAGIC, sizeof(FASL_MAGIC)) != 0) return std::nullopt;
+        if (reader.readU32() != FASL_BYTE_ORDER) return std::nullopt;
+        FaslKey stored;
+        stored.mtime = static_cast<std::int64_t>(reader.readU64());
+        stored.size = reader.readU64();
+        stored.hash = reader.readU64();
+        if (!(stored == key)) return std::nullopt;
+        reader.readSymbolTable();
+        auto count = reader.readCount();
+        std::vector<ValuePtr> forms;
+        forms.reserve(count);
+        for (std::uint32_t i = 0; i < count; i++) forms.push_back(reader.readValue());
+        return forms;
+    } catch (FileError&) {
+        return std::nullopt;
+    }
+}
+
+void writeFasl(const std::string& path, const FaslKey& key, const std::vector<ValuePtr>& forms) {
+    FaslWriter writer;
+    try {
+        writer.writeU32(static_cast<std::uint32_t>(forms.size()));
+        for (const auto& form : forms) writer.writeValue(form);
+    } catch (LispError&) {
+        return;
+    }
+    FaslWriter header;
+    for (char c : FASL_MAGIC) header.writeU8(static_cast<std::uint8_t>(c));
+    header.writeU32(FASL_BYTE_ORDER);
+    header.writeU64(static_cast<std::uint64_t>(key.mtime));
+    header.writeU64(key.size);
+    header.writeU64(key.hash);
+    std::string data = header.raw() + writer.finish();
+
+    // 先写临时文件再改名，避免并发加载读到写了一半的缓存
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) return;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) std::filesystem::remove(temp, ec);
+}
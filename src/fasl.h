@@ -0,0 +1,124 @@
+#ifndef FASL_H
+#define FASL_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "./value.h"
+
+// FASL（fast-load）缓存：把解析后的表达式序列化为紧凑的二进制格式，
+// 再次加载同一源文件时直接反序列化，跳过词法分析与语法分析。
+
+// 源文件的缓存键：修改时间、文件大小与内容哈希
+struct FaslKey {
+    std::int64_t mtime = 0;
+    std::uint64_t size = 0;
+    std::uint64_t hash = 0;
+
+    bool operator==(const FaslKey& other) const = default;
+};
+
+// 数据区中每个值的类型标记，EXTENDED 起的标记留给扩展格式使用
+enum FaslTag : std::uint8_t {
+    FASL_NIL,
+    FASL_FALSE,
+    FASL_TRUE,
+    FASL_NUMBER,
+    FASL_STRING,
+    FASL_SYMBOL,
+    FASL_LIST,
+    FASL_VECTOR,
+    FASL_EXTENDED = 32,
+};
+
+// 只读映射一个文件的全部内容（POSIX 下使用 mmap）
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return begin; }
+    std::size_t size() const { return length; }
+
+private:
+    bool opened = false;
+    const char* begin = nullptr;
+    std::size_t length = 0;
+    std::string buffer;  // 不支持 mmap 时的后备存储
+};
+
+class FaslWriter {
+public:
+    virtual ~FaslWriter() = default;
+
+    void writeU8(std::uint8_t value);
+    void writeU32(std::uint32_t value);
+    void writeU64(std::uint64_t value);
+    void writeDouble(double value);
+    void writeBytes(const std::string& bytes);
+    void writeValue(const ValuePtr& value);
+
+    // 输出符号表与数据区
+    std::string finish() const;
+    // 只输出数据区，用于不含符号的文件头
+    const std::string& raw() const { return body; }
+
+protected:
+    // 遇到基础格式之外的值时调用
+    virtual void writeExtended(const ValuePtr& value);
+    // 为真时对子与向量不按值展开，也交给 writeExtended 按引用写出
+    virtual bool isReference(const Value&) const { return false; }
+
+private:
+    std::string body;
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, std::uint32_t> symbolIndex;
+    // 正在按值展开的列表与向量，再次遇到说明结构带环
+    std::unordered_set<const Value*> expanding;
+};
+
+class FaslReader {
+public:
+    FaslReader(const char* begin, const char* end);
+    virtual ~FaslReader() = default;
+
+    std::uint8_t readU8();
+    std::uint32_t readU32();
+    std::uint64_t readU64();
+    double readDouble();
+    std::string readBytes();
+    // 读取元素个数；每个元素至少占 minSize 字节，剩余数据不够时视为损坏，避免按错误的个数分配内存
+    std::uint32_t readCount(std::size_t minSize = 1);
+    ValuePtr readValue();
+
+    // 读取 FaslWriter::finish 输出开头的符号表
+    void readSymbolTable();
+    bool atEnd() const { return pos == end; }
+
+protected:
+    virtual ValuePtr readExtended(std::uint8_t tag);
+
+private:
+    const char* pos;
+    const char* end;
+    std::vector<ValuePtr> symbols;
+
+    void require(std::size_t n) const;
+};
+
+FaslKey makeFaslKey(const std::string& filename, const std::string& source);
+std::string faslPath(const std::string& filename);
+
+// 读取缓存，文件不存在、键不匹配或格式损坏时返回空
+std::optional<std::vector<ValuePtr>> readFasl(const std::string& path, const FaslKey& key);
+// 写入缓存，失败时静默放弃（缓存只是加速手段）
+void writeFasl(const std::string& path, const FaslKey& key, const std::vector<ValuePtr>& forms);
+
+#endif
@@ -1,10 +1,18 @@
 #include "./read.h"
 #include "./forms.h"
+#include "./future.h"
+#include "./promise.h"
 #include "./builtins.h"
+#include "./optimizer.h"
+#include "./stats.h"
 #include "./token.h"
 #include "./tokenizer.h"
 #include "./parser.h"
 #include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <unordered_set>
 #include <iterator>
 
 
@@ -13,9 +21,60 @@ std::string LambdaValue::toString() const {
 }
 
 ValuePtr LambdaValue::apply(const std::vector<ValuePtr>& args) const{
+    if (traced.load(std::memory_order_relaxed)) return applyTraced(args);
     auto kid = this->env->createChild(this->params, args);
     ValuePtr result;
-    for (const auto& i : this->body) result = kid->eval(i);
+    for (const auto& i : code()) result = kid->eval(i);
+    return result;
+}
+
+// 内联时跳过被跟踪的过程，开关跟踪后内联过它的过程体随之失效
+void LambdaValue::setTraced(bool value){
+    traced.store(value, std::memory_order_relaxed);
+    invalidateInlining();
+}
+
+void LambdaValue::setFolded(FoldedBody value, std::uint64_t epoch){
+    folded = std::move(value);
+    checkedEpoch.store(epoch, std::memory_order_relaxed);
+    hasFolded = true;
+}
+
+// foldEpoch 变化说明有被依赖的名字改变了，只核对本过程体依赖的那些名字
+const std::vector<ValuePtr>& LambdaValue::code() const{
+    if (!hasFolded || foldStale.load(std::memory_order_relaxed)) return body;
+    auto epoch = foldEpoch.load(std::memory_order_acquire);
+    if (checkedEpoch.load(std::memory_order_relaxed) == epoch) return folded.body;
+    if (!stillValid(folded.dependencies)) {
+        foldStale.store(true, std::memory_order_relaxed);
+        return body;
+    }
+    checkedEpoch.store(epoch, std::memory_order_relaxed);
+    return folded.body;
+}
+
+// 被跟踪过程的嵌套层数，用于缩进
+static thread_local int traceDepth = 0;
+
+ValuePtr LambdaValue::applyTraced(const std::vector<ValuePtr>& args) const{
+    std::string indent(traceDepth, ' ');
+    std::cout << indent << ">(" << name;
+    for (const auto& arg : args) std::cout << ' ' << arg->toString();
+    std::cout << ')' << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    traceDepth++;
+    ValuePtr result;
+    try {
+        auto kid = this->env->createChild(this->params, args);
+        for (const auto& i : code()) result = kid->eval(i);
+    } catch (...) {
+        traceDepth--;
+        throw;
+    }
+    traceDepth--;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << indent << '<' << result->toString() << " (" << std::fixed << std::setprecision(3)
+              << elapsed.count() << " ms)" << std::defaultfloat << std::endl;
     return result;
 }
 
@@ -28,7 +87,10 @@ ValuePtr lambdaForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     std::vector<std::string> paramNames;
     std::transform(params.begin(), params.end(), std::back_inserter(paramNames), [](ValuePtr i){return i->toString();});
     std::vector<ValuePtr> body(args.begin() + 1, args.end());
-    return std::make_shared<LambdaValue>(paramNames, body, env.shared_from_this());
+    auto lambda = std::make_shared<LambdaValue>(paramNames, body, env.shared_from_this());
+    auto epoch = foldEpoch.load(std::memory_order_relaxed);
+    if (auto folded = foldBody(paramNames, body, env)) lambda->setFolded(std::move(*folded), epoch);
+    return lambda;
 }
 
 ValuePtr defineForm(const std::vector<ValuePtr>& args, EvalEnv& env) {
@@ -38,13 +100,21 @@ ValuePtr defineForm(const std::vector<ValuePtr>& args, EvalEnv& env) {
     auto first = args[0];
     if(first->asSymbol()){
         auto name = first->asSymbol();
-        env.defineBinding(*name, env.eval(args[1]));
+        auto value = env.eval(args[1]);
+        // (define f (lambda ...)) 也给匿名过程记下名字
+        if(typeid(*value) == typeid(LambdaValue)){
+            auto& lambda = static_cast<LambdaValue&>(*value);
+            if(lambda.getName() == "(lambda)") lambda.setName(*name);
+        }
+        env.defineBinding(*name, value);
         return std::make_shared<NilValue>();
     } else if (first->isPair()){
         auto name = first->CAR()->toString();
         std::vector<ValuePtr> values{first->CDR()};
-        for (int i = 1; i < args.size(); i++) values.emplace_back(args[i]);
-        env.defineBinding(name, lambdaForm(values, env));
+        for (std::size_t i = 1; i < args.size(); i++) values.emplace_back(args[i]);
+        auto lambda = lambdaForm(values, env);
+        static_cast<LambdaValue&>(*lambda).setName(name);
+        env.defineBinding(name, lambda);
         return std::make_shared<NilValue>();
     } else {
         throw LispError("Unimplemented");
@@ -52,6 +122,18 @@ ValuePtr defineForm(const std::vector<ValuePtr>& args, EvalEnv& env) {
 
 }
 
+ValuePtr setForm(const std::vector<ValuePtr>& args, EvalEnv& env) {
+    if (args.size() != 2) {
+        throw LispError("Invalid number of arguments for set!");
+    }
+    auto name = args[0]->asSymbol();
+    if (!name) {
+        throw LispError("set! expects a variable name");
+    }
+    env.setBinding(*name, env.eval(args[1]));
+    return std::make_shared<NilValue>();
+}
+
 ValuePtr quoteForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     if (args.size() != 1) {
         throw LispError("Invalid number of arguments for quote");
@@ -104,7 +186,7 @@ ValuePtr condForm(const std::vector<ValuePtr>& args, EvalEnv& env) {
     if (args.size() >= 2) {
         ValuePtr result;
         bool flag = true; // 判断是否所有字句都被跳过
-        for (int i = 0; i < args.size(); i++) {
+        for (std::size_t i = 0; i < args.size(); i++) {
             auto relation = args[i]->toVector();
             if (relation[0]->toString() == "else"){
                 if(i != args.size() - 1) throw LispError("Invalid else position");
@@ -123,14 +205,192 @@ ValuePtr condForm(const std::vector<ValuePtr>& args, EvalEnv& env) {
         throw LispError("Invalid number of arguments for cond");
 }
 
+// 会把当前环境保存下来（闭包）或往其中添加绑定的特殊形式。
+// 循环体中不出现这些形式时，循环可以原地复用同一个环境。
+static const std::unordered_set<std::string> CAPTURING_FORMS{
+    "lambda", "define", "load-file", "read-line", "future", "delay", "cons-stream"
+};
+
+static bool capturesEnv(const ValuePtr& expr){
+    if(auto name = expr->asSymbol()) return CAPTURING_FORMS.contains(*name);
+    if(expr->isVector()){
+        for(const auto& element : static_cast<const VectorValue&>(*expr).getElements()){
+            if(capturesEnv(element)) return true;
+        }
+        return false;
+    }
+    bool found = false;
+    ValuePtr current = expr;
+    while(!found && current->isPair()){
+        found = capturesEnv(current->CAR());
+        current = current->CDR();
+    }
+    return found;
+}
+
+static bool anyCapturesEnv(std::vector<ValuePtr>::const_iterator first, std::vector<ValuePtr>::const_iterator last){
+    return std::any_of(first, last, [](const ValuePtr& expr){ return capturesEnv(expr); });
+}
+
+// 解析 ((name init ...) ...) 形式的绑定表
+static void parseBindings(const ValuePtr& list, std::size_t minSize, std::size_t maxSize, const std::string& formName,
+                          std::vector<std::string>& names, std::vector<std::vector<ValuePtr>>& parts){
+    for(const auto& binding : list->toVector()){
+        auto var = binding->toVector();
+        if(var.size() < minSize || var.size() > maxSize || !var[0]->asSymbol()){
+            throw LispError("Invalid binding for " + formName);
+        }
+        names.emplace_back(*var[0]->asSymbol());
+        parts.emplace_back(var.begin() + 1, var.end());
+    }
+}
+
+// 判断 loop 在 expr 中是否只以尾调用的形式出现。
+// 只认得 runTail 能就地展开的几种形式，其余一律按非尾位置检查。
+static bool onlyTailCalls(const ValuePtr& expr, const std::string& loop, bool tail){
+    if(auto name = expr->asSymbol()) return *name != loop;
+    if(!expr->isPair()) return true;
+    auto items = expr->toVector();
+    auto all = [&](std::size_t from, std::size_t to, bool isTail){
+        for(auto i = from; i < to; i++){
+            if(!onlyTailCalls(items[i], loop, isTail)) return false;
+        }
+        return true;
+    };
+    auto head = items[0]->asSymbol();
+    if(head == "quote") return true;
+    if(head == loop) return tail && all(1, items.size(), false);
+    if(head == "if" && (items.size() == 3 || items.size() == 4)){
+        return all(1, 2, false) && all(2, items.size(), tail);
+    }
+    if(head == "begin" && items.size() >= 2){
+        return all(1, items.size() - 1, false) && all(items.size() - 1, items.size(), tail);
+    }
+    if(head == "cond" && items.size() >= 3){
+        for(std::size_t i = 1; i < items.size(); i++){
+            if(!items[i]->isPair()) return false;
+            auto clause = items[i]->toVector();
+            bool isElse = clause[0]->toString() == "else";
+            if(isElse && clause.size() < 2) return false;
+            if(clause.size() == 1){
+                if(!onlyTailCalls(clause[0], loop, tail)) return false;
+                continue;
+            }
+            if(!isElse && !onlyTailCalls(clause[0], loop, false)) return false;
+            // condForm 只求值子句的第一个表达式
+            if(!onlyTailCalls(clause[1], loop, tail)) return false;
+            for(std::size_t j = 2; j < clause.size(); j++){
+                if(!onlyTailCalls(clause[j], loop, false)) return false;
+            }
+        }
+        return true;
+    }
+    if(head == "let" && items.size() >= 3 && (items[1]->isPair() || items[1]->isNil())){
+        for(const auto& binding : items[1]->toVector()){
+            auto var = binding->toVector();
+            if(var.size() != 2 || var[0]->asSymbol() == loop) return false;
+            if(!onlyTailCalls(var[1], loop, false)) return false;
+        }
+        return all(2, items.size() - 1, false) && all(items.size() - 1, items.size(), tail);
+    }
+    return all(0, items.size(), false);
+}
+
+// 在尾位置求值 expr。遇到对 loop 的尾调用时把实参存入 next 并返回空指针，
+// 否则返回表达式的值。与 onlyTailCalls 认得的形式一一对应。
+static ValuePtr runTail(const ValuePtr& expr, EvalEnv& env, const std::string& loop, std::vector<ValuePtr>& next){
+    if(!expr->isPair()) return env.eval(expr);
+    auto head = expr->CAR()->asSymbol();
+    if(head == loop){
+        next = env.evalList(expr->CDR());
+        return nullptr;
+    }
+    auto items = expr->CDR()->toVector();
+    if(head == "if" && (items.size() == 2 || items.size() == 3)){
+        if(env.eval(items[0])->asBool()) return runTail(items[1], env, loop, next);
+        return items.size() == 3 ? runTail(items[2], env, loop, next) : std::make_shared<NilValue>();
+    }
+    if(head == "begin" && !items.empty()){
+        for(std::size_t i = 0; i + 1 < items.size(); i++) env.eval(items[i]);
+        return runTail(items.back(), env, loop, next);
+    }
+    if(head == "cond" && items.size() >= 2){
+        for(std::size_t i = 0; i < items.size(); i++){
+            auto relation = items[i]->toVector();
+            if(relation[0]->toString() == "else"){
+                if(i != items.size() - 1) throw LispError("Invalid else position");
+                return runTail(relation[1], env, loop, next);
+            }
+            if(relation.size() == 1) return runTail(relation[0], env, loop, next);
+            if(env.eval(relation[0])->asBool()) return runTail(relation[1], env, loop, next);
+        }
+        throw LispError("Invalid cond");
+    }
+    if(head == "let" && items.size() >= 2 && (items[0]->isPair() || items[0]->isNil())){
+        std::vector<std::string> names;
+        std::vector<ValuePtr> values;
+        for(const auto& binding : items[0]->toVector()){
+            auto var = binding->toVector();
+            names.emplace_back(var[0]->toString());
+            values.emplace_back(env.eval(var[1]));
+        }
+        auto child = env.createChild(names, values);
+        for(std::size_t i = 1; i + 1 < items.size(); i++) child->eval(items[i]);
+        return runTail(items.back(), *child, loop, next);
+    }
+    return env.eval(expr);
+}
+
+// 命名 let：(let name ((var init) ...) body ...)
+static ValuePtr namedLetForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() < 3){
+        throw LispError("Invalid number of arguments for let");
+    }
+    auto loop = *args[0]->asSymbol();
+    std::vector<std::string> names;
+    std::vector<std::vector<ValuePtr>> inits;
+    parseBindings(args[1], 2, 2, "let", names, inits);
+    std::vector<ValuePtr> values;
+    for(const auto& init : inits) values.emplace_back(env.eval(init[0]));
+
+    bool inPlace = !anyCapturesEnv(args.begin() + 2, args.end()) &&
+                   std::all_of(args.begin() + 2, args.end() - 1, [&](const ValuePtr& expr){
+                       return onlyTailCalls(expr, loop, false);
+                   }) &&
+                   onlyTailCalls(args.back(), loop, true);
+    if(!inPlace){
+        // 一般情形：把循环体当作过程，绑定在只对循环体可见的环境中
+        auto scope = env.createChild({}, {});
+        std::vector<ValuePtr> body(args.begin() + 2, args.end());
+        auto proc = std::make_shared<LambdaValue>(names, body, scope);
+        scope->defineBinding(loop, proc);
+        return proc->apply(values);
+    }
+    // 循环名只出现在尾调用处且没有闭包保存环境：复用同一个环境，尾调用改为更新绑定后重新执行
+    auto frame = env.createChild(names, values);
+    values.clear();  // 不再持有初值，循环中丢弃的值（如走过的流）可以及时释放
+    auto slots = frame->localSlots(names);
+    std::vector<ValuePtr> next;
+    while(true){
+        for(auto it = args.begin() + 2; it != args.end() - 1; ++it) frame->eval(*it);
+        auto result = runTail(args.back(), *frame, loop, next);
+        if(result) return result;
+        if(next.size() != names.size()) throw LispError("arguments not matched");
+        for(std::size_t i = 0; i < names.size(); i++) *slots[i] = std::move(next[i]);
+    }
+}
+
 ValuePtr letForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     if(args.size() < 2){
         throw LispError("Invalid number of arguments for let");
     }
+    if(args[0]->asSymbol()){
+        return namedLetForm(args, env);
+    }
     auto bindings = args[0]->toVector();
     std::vector<std::string> varNames;
     std::vector<ValuePtr> varValues;
-    for (int i = 0; i < bindings.size(); i++){
+    for (std::size_t i = 0; i < bindings.size(); i++){
         auto var = bindings[i]->toVector();
         if(var.size() != 2){
             throw LispError("Invalid number of arguments for let");
@@ -140,12 +400,88 @@ ValuePtr letForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     }
     auto envChild = env.createChild(varNames, varValues);
     ValuePtr result;
-    for (int i = 1; i < args.size(); i++){
+    for (std::size_t i = 1; i < args.size(); i++){
         result = envChild->eval(args[i]);
     }
     return result;
 }
 
+ValuePtr letStarForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() < 2){
+        throw LispError("Invalid number of arguments for let*");
+    }
+    std::vector<std::string> names;
+    std::vector<std::vector<ValuePtr>> inits;
+    parseBindings(args[0], 2, 2, "let*", names, inits);
+    // 依次绑定到同一个环境；名字重复，或初值中的闭包可能看到后面的绑定时，才另开子环境
+    bool nested = std::any_of(inits.begin(), inits.end(), [](const auto& init){ return capturesEnv(init[0]); });
+    auto frame = env.createChild({}, {});
+    for(std::size_t i = 0; i < names.size(); i++){
+        auto value = frame->eval(inits[i][0]);
+        if(nested || frame->findLocal(names[i])) frame = frame->createChild({}, {});
+        frame->bindLocal(names[i], value);
+    }
+    ValuePtr result;
+    for(std::size_t i = 1; i < args.size(); i++) result = frame->eval(args[i]);
+    return result;
+}
+
+ValuePtr letrecForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() < 2){
+        throw LispError("Invalid number of arguments for letrec");
+    }
+    std::vector<std::string> names;
+    std::vector<std::vector<ValuePtr>> inits;
+    parseBindings(args[0], 2, 2, "letrec", names, inits);
+    // 先在新环境中占位，初值都求出后再统一绑定，初值中的过程因此可以互相引用
+    std::vector<ValuePtr> placeholders(names.size(), std::make_shared<NilValue>());
+    auto frame = env.createChild(names, placeholders);
+    std::vector<ValuePtr> values;
+    for(const auto& init : inits) values.emplace_back(frame->eval(init[0]));
+    for(std::size_t i = 0; i < names.size(); i++) frame->bindLocal(names[i], values[i]);
+    ValuePtr result;
+    for(std::size_t i = 1; i < args.size(); i++) result = frame->eval(args[i]);
+    return result;
+}
+
+// (do ((var init [step]) ...) (test expr ...) body ...)
+ValuePtr doForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() < 2 || !args[1]->isPair()){
+        throw LispError("Invalid number of arguments for do");
+    }
+    std::vector<std::string> names;
+    std::vector<std::vector<ValuePtr>> parts;
+    parseBindings(args[0], 2, 3, "do", names, parts);
+    auto exit = args[1]->toVector();
+    std::vector<ValuePtr> values;
+    for(const auto& part : parts) values.emplace_back(env.eval(part[0]));
+
+    // 没有闭包保存循环环境时原地更新变量，否则每轮使用新环境，闭包各自看到当轮的值
+    bool inPlace = !anyCapturesEnv(args.begin() + 1, args.end());
+    for(const auto& part : parts){
+        if(part.size() == 2 && capturesEnv(part[1])) inPlace = false;
+    }
+    auto frame = env.createChild(names, values);
+    values.clear();
+    auto slots = inPlace ? frame->localSlots(names) : std::vector<ValuePtr*>{};
+    std::vector<ValuePtr> steps(names.size());
+    while(!frame->eval(exit[0])->asBool()){
+        for(auto it = args.begin() + 2; it != args.end(); ++it) frame->eval(*it);
+        // 步进表达式都在旧值上求出后再一起更新
+        for(std::size_t i = 0; i < names.size(); i++){
+            steps[i] = parts[i].size() == 2 ? frame->eval(parts[i][1]) : frame->lookupBinding(names[i]);
+        }
+        if(inPlace){
+            for(std::size_t i = 0; i < names.size(); i++) *slots[i] = std::move(steps[i]);
+        } else {
+            frame = env.createChild(names, steps);
+        }
+    }
+    ValuePtr result = std::make_shared<NilValue>();
+    for(std::size_t i = 1; i < exit.size(); i++) result = frame->eval(exit[i]);
+    return result;
+}
+
 ValuePtr beginForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     if(args.empty()){
         throw LispError("Invalid number of arguments for begin");
@@ -157,6 +493,82 @@ ValuePtr beginForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     return result;
 }
 
+ValuePtr futureForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() != 1){
+        throw LispError("Invalid number of arguments for future");
+    }
+    return std::make_shared<FutureValue>([expr = args[0], env = env.shared_from_this()] {
+        return env->eval(expr);
+    });
+}
+
+ValuePtr delayForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() != 1){
+        throw LispError("Invalid number of arguments for delay");
+    }
+    return std::make_shared<PromiseValue>(args[0], env.shared_from_this());
+}
+
+// (cons-stream a b) 即 (cons a (delay b))
+ValuePtr consStreamForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() != 2){
+        throw LispError("Invalid number of arguments for cons-stream");
+    }
+    auto head = env.eval(args[0]);
+    return std::make_shared<PairValue>(head, std::make_shared<PromiseValue>(args[1], env.shared_from_this()));
+}
+
+// (time expr)：求值 expr 并返回其值，同时打印墙钟时间、CPU 时间与当前线程的分配次数
+ValuePtr timeForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.size() != 1){
+        throw LispError("Invalid number of arguments for time");
+    }
+    auto allocations = threadAllocationCount();
+    auto cpu = std::clock();
+    auto wall = std::chrono::steady_clock::now();
+    auto result = env.eval(args[0]);
+    std::chrono::duration<double, std::milli> real = std::chrono::steady_clock::now() - wall;
+    double cpuMs = 1000.0 * (std::clock() - cpu) / CLOCKS_PER_SEC;
+    allocations = threadAllocationCount() - allocations;
+    std::cout << std::fixed << std::setprecision(3) << "real time: " << real.count() << " ms, cpu time: "
+              << cpuMs << " ms, allocations: " << allocations << std::defaultfloat << std::endl;
+    return result;
+}
+
+// 取出名字绑定的 lambda 过程，不是则返回空
+static LambdaValue* tracedLambda(const ValuePtr& arg, EvalEnv& env){
+    auto name = arg->asSymbol();
+    if(!name) return nullptr;
+    auto value = env.lookupBinding(*name);
+    return typeid(*value) == typeid(LambdaValue) ? static_cast<LambdaValue*>(value.get()) : nullptr;
+}
+
+// (trace f ...) 跟踪 define 定义的过程。只有一个参数且不是过程名时，
+// 仍按原先的内置过程 trace 求矩阵的迹
+ValuePtr traceForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    if(args.empty()){
+        throw LispError("Invalid number of arguments for trace");
+    }
+    if(args.size() == 1 && !tracedLambda(args[0], env)){
+        return env.apply(env.lookupBinding("trace"), {env.eval(args[0])});
+    }
+    for(const auto& arg : args){
+        auto lambda = tracedLambda(arg, env);
+        if(!lambda) throw LispError("trace expects procedure names, got " + arg->toString());
+        lambda->setTraced(true);
+    }
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr untraceForm(const std::vector<ValuePtr>& args, EvalEnv& env){
+    for(const auto& arg : args){
+        auto lambda = tracedLambda(arg, env);
+        if(!lambda) throw LispError("untrace expects procedure names, got " + arg->toString());
+        lambda->setTraced(false);
+    }
+    return std::make_shared<NilValue>();
+}
+
 ValuePtr quasiquoteForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     if(args.size() != 1){
         throw LispError("Invalid number of arguments for quasiquote, should be only 1");
@@ -180,8 +592,8 @@ ValuePtr loadFileForm(const std::vector<ValuePtr>& args, EvalEnv& env){
     if(args.size() != 1){
         throw LispError("Invalid number of arguments for load-file");
     }
-    std::string filename = args[0]->toString();
-    filemode(filename);
+    std::string filename = args[0]->isString() ? args[0]->asString() : args[0]->toString();
+    loadFile(filename, env);
     return std::make_shared<NilValue>();
 }
 
@@ -201,13 +613,23 @@ ValuePtr readlineForm(const std::vector<ValuePtr>& args, EvalEnv& env){
 const std::unordered_map<std::string, SpecialFormType*> SPECIAL_FORMS{
     {"lambda",lambdaForm},
     {"define", defineForm},
+    {"set!", setForm},
     {"quote", quoteForm},
     {"if", ifForm},
     {"and", andForm},
     {"or", orForm},
     {"cond", condForm},
     {"let", letForm},
+    {"let*", letStarForm},
+    {"letrec", letrecForm},
+    {"do", doForm},
     {"begin", beginForm},
+    {"future", futureForm},
+    {"delay", delayForm},
+    {"cons-stream", consStreamForm},
+    {"time", timeForm},
+    {"trace", traceForm},
+    {"untrace", untraceForm},
     {"quasiquote", quasiquoteForm},
     {"load-file", loadFileForm},
     {"read-line", readlineForm}
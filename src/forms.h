@@ -3,7 +3,10 @@
 
 #include "./value.h"
 #include "./eval_env.h"
+#include "./optimizer.h"
 
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
@@ -11,14 +14,37 @@ using SpecialFormType = std::shared_ptr<Value>(const std::vector<ValuePtr>&, Eva
 
 class LambdaValue : public Value{
 public:
-    LambdaValue(const std::vector<std::string>& params, const std::vector<ValuePtr>& body, std::shared_ptr<EvalEnv> env): params(params), body(body), env(env) {}
+    LambdaValue(const std::vector<std::string>& params, const std::vector<ValuePtr>& body, std::shared_ptr<EvalEnv> env): Value(STAT_VALUE_LAMBDA), params(params), body(body), env(env) {}
     std::string toString() const override;
+    bool isProcedure() const override { return true; }
     ValuePtr apply(const std::vector<ValuePtr>& args) const;
+    const std::vector<std::string>& getParams() const { return params; }
+    const std::vector<ValuePtr>& getBody() const { return body; }
+    std::shared_ptr<EvalEnv> getEnv() const { return env; }
+    // 由 define 记下的名字，供分析器报告使用；匿名过程为 (lambda)
+    const std::string& getName() const { return name; }
+    void setName(const std::string& value) { name = value; }
+    // 由 trace 打开后，每次调用打印参数、返回值与耗时
+    void setTraced(bool value);
+    bool isTraced() const { return traced.load(std::memory_order_relaxed); }
+    // 记下常量折叠后的过程体，epoch 为开始折叠时的 foldEpoch
+    void setFolded(FoldedBody value, std::uint64_t epoch);
 
 private:
+    std::string name = "(lambda)";
+    std::atomic<bool> traced{false};
+    FoldedBody folded;
+    bool hasFolded = false;
+    // 最近一次确认折叠结果仍然有效时的 foldEpoch；依赖的名字被修改后折叠结果不再使用
+    mutable std::atomic<std::uint64_t> checkedEpoch{0};
+    mutable std::atomic<bool> foldStale{false};
     std::vector<std::string> params;
     std::vector<ValuePtr> body;    
     std::shared_ptr<EvalEnv> env;
+
+    ValuePtr applyTraced(const std::vector<ValuePtr>& args) const;
+    // 折叠后的过程体仍然有效时使用它，否则使用原过程体
+    const std::vector<ValuePtr>& code() const;
 };
 
 extern const std::unordered_map<std::string, SpecialFormType*> SPECIAL_FORMS;
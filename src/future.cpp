@@ -0,0 +1,50 @@
+#include "./future.h"
+#include "./parallel.h"
+
+#include <chrono>
+#include <thread>
+
+FutureValue::FutureValue(std::function<ValuePtr()> job, bool dedicated) : state(std::make_shared<State>()) {
+    // 计数在提交之前增加，计算开始时创建者已经按有 future 运行的方式加锁
+    runningFutures.fetch_add(1, std::memory_order_acq_rel);
+    auto task = [state = state, job = std::move(job)] {
+        ValuePtr result;
+        std::exception_ptr error;
+        try {
+            TaskScope scope;
+            result = job();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        runningFutures.fetch_sub(1, std::memory_order_acq_rel);
+        {
+            std::lock_guard lock(state->mutex);
+            state->result = std::move(result);
+            state->error = error;
+            state->done = true;
+        }
+        state->ready.notify_all();
+    };
+    if (dedicated) {
+        std::thread(std::move(task)).detach();
+    } else {
+        defaultPool().submit(std::move(task));
+    }
+}
+
+ValuePtr FutureValue::touch() {
+    auto& pool = defaultPool();
+    while (true) {
+        {
+            std::unique_lock lock(state->mutex);
+            if (state->done) break;
+        }
+        // 先帮忙执行排队的任务（可能正是本 future），没有任务时短暂等待后再查看
+        if (!pool.runPending()) {
+            std::unique_lock lock(state->mutex);
+            state->ready.wait_for(lock, std::chrono::milliseconds(1), [this] { return state->done; });
+        }
+    }
+    if (state->error) std::rethrow_exception(state->error);
+    return state->result;
+}
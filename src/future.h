@@ -0,0 +1,38 @@
+#ifndef FUTURE_H
+#define FUTURE_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "./eval_env.h"
+#include "./value.h"
+
+// future：在后台线程上异步执行一项计算，结果求出后缓存。
+// 计算作为一个任务在创建 future 的环境中进行，只能读取而不能修改该环境的绑定；
+// 运行期间创建者仍可定义或修改绑定，双方读写绑定时加锁。
+class FutureValue : public Value {
+public:
+    // dedicated 为真时在新线程上运行，用于可能长时间阻塞（如等待通道）的计算，
+    // 否则交给共享线程池
+    explicit FutureValue(std::function<ValuePtr()> job, bool dedicated = false);
+    std::string toString() const override { return "#<future>"; }
+    bool isTransferable() const override { return false; }
+
+    // 等待结果；等待期间帮助线程池执行其他任务。求值出错时重新抛出该错误。
+    ValuePtr touch();
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable ready;
+        bool done = false;
+        ValuePtr result;
+        std::exception_ptr error;
+    };
+    std::shared_ptr<State> state;
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "./hash_table.h"
+#include "./builtins.h"
+#include "./vector_value.h"
+
+#include <functional>
+#include <string_view>
+
+namespace {
+
+constexpr std::size_t INITIAL_CAPACITY = 8;
+constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+std::size_t combine(std::size_t seed, std::size_t hash) {
+    return seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+}  // namespace
+
+std::size_t hashValue(const Value& value) {
+    if (value.isNumber()) {
+        double number = value.asNumber();
+        if (number == 0) number = 0;  // 0.0 与 -0.0 相等，哈希也须相同
+        return combine(std::hash<double>{}(number), value.isRational());
+    }
+    if (value.isSymbol()) return static_cast<const SymbolValue&>(value).getHash();
+    if (value.isString()) {
+        return std::hash<std::string_view>{}(static_cast<const StringValue&>(value).getValue());
+    }
+    if (value.isBool()) return value.asBool() ? 1 : 2;
+    if (value.isNil()) return 3;
+    if (value.isPair()) {
+        std::size_t seed = 4;
+        const Value* current = &value;
+        while (current->isPair()) {
+            auto pair = static_cast<const PairValue*>(current);
+            seed = combine(seed, hashValue(*pair->getCar()));
+            current = pair->getCdr().get();
+        }
+        return combine(seed, hashValue(*current));
+    }
+    if (value.isVector()) {
+        std::size_t seed = 5;
+        for (const auto& element : static_cast<const VectorValue&>(value).getElements()) {
+            seed = combine(seed, hashValue(*element));
+        }
+        return seed;
+    }
+    // 矩阵按内容比较，只用形状作哈希
+    if (value.isMatrix()) return combine(value.getrows(), value.getcols());
+    // 其余值只与自身相等
+    return std::hash<const Value*>{}(&value);
+}
+
+HashTableValue::HashTableValue() : Value(STAT_VALUE_HASH_TABLE), slots(INITIAL_CAPACITY) {}
+
+std::string HashTableValue::toString() const {
+    return "#<hash-table:" + std::to_string(count) + ">";
+}
+
+std::size_t HashTableValue::findIndex(const ValuePtr& key, std::size_t hash) const {
+    std::size_t index = hash & mask();
+    for (std::int32_t distance = 0;; distance++) {
+        const auto& slot = slots[index];
+        // 遇到空槽或比当前探测距离更“富”的元素，说明键不存在
+        if (slot.distance < distance) return NOT_FOUND;
+        if (slot.hash == hash && isEqual(slot.key, key)) return index;
+        index = (index + 1) & mask();
+    }
+}
+
+ValuePtr HashTableValue::find(const ValuePtr& key) const {
+    auto index = findIndex(key, hashValue(*key));
+    return index == NOT_FOUND ? nullptr : slots[index].value;
+}
+
+void HashTableValue::place(Slot slot) {
+    std::size_t index = slot.hash & mask();
+    slot.distance = 0;
+    while (true) {
+        auto& current = slots[index];
+        if (current.distance < 0) {
+            current = std::move(slot);
+            return;
+        }
+        // robin-hood：探测距离更短的元素让位
+        if (current.distance < slot.distance) std::swap(current, slot);
+        index = (index + 1) & mask();
+        slot.distance++;
+    }
+}
+
+void HashTableValue::grow() {
+    std::vector<Slot> old(slots.size() * 2);
+    old.swap(slots);
+    for (auto& slot : old) {
+        if (slot.distance >= 0) place(std::move(slot));
+    }
+}
+
+void HashTableValue::insert(const ValuePtr& key, const ValuePtr& value) {
+    auto hash = hashValue(*key);
+    auto index = findIndex(key, hash);
+    if (index != NOT_FOUND) {
+        slots[index].value = value;
+        return;
+    }
+    // 装载因子不超过 7/8
+    if ((count + 1) * 8 > slots.size() * 7) grow();
+    place(Slot{key, value, hash, 0});
+    count++;
+}
+
+bool HashTableValue::erase(const ValuePtr& key) {
+    auto index = findIndex(key, hashValue(*key));
+    if (index == NOT_FOUND) return false;
+    // 后移删除：把后继元素逐个前移，直到遇到空槽或已在理想位置的元素
+    auto next = (index + 1) & mask();
+    while (slots[next].distance > 0) {
+        slots[index] = std::move(slots[next]);
+        slots[index].distance--;
+        index = next;
+        next = (next + 1) & mask();
+    }
+    slots[index] = Slot{};
+    count--;
+    return true;
+}
+
+std::vector<ValuePtr> HashTableValue::keys() const {
+    std::vector<ValuePtr> result;
+    result.reserve(count);
+    for (const auto& slot : slots) {
+        if (slot.distance >= 0) result.push_back(slot.key);
+    }
+    return result;
+}
+
+std::vector<std::pair<ValuePtr, ValuePtr>> HashTableValue::entries() const {
+    std::vector<std::pair<ValuePtr, ValuePtr>> result;
+    result.reserve(count);
+    for (const auto& slot : slots) {
+        if (slot.distance >= 0) result.emplace_back(slot.key, slot.value);
+    }
+    return result;
+}
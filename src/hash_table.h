@@ -0,0 +1,44 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+
+#include "./value.h"
+#include <cstdint>
+#include <vector>
+
+// 与 equal? 一致的哈希：相等的值哈希相同
+std::size_t hashValue(const Value& value);
+
+// 哈希表：开放寻址，冲突时按 robin-hood 规则让探测距离更长的元素占位，
+// 删除时把后继元素向前平移，不留墓碑。键按 equal? 比较。
+class HashTableValue : public Value {
+public:
+    HashTableValue();
+    std::string toString() const override;
+    bool isHashTable() const override { return true; }
+
+    // 查找键，不存在时返回空指针
+    ValuePtr find(const ValuePtr& key) const;
+    void insert(const ValuePtr& key, const ValuePtr& value);
+    bool erase(const ValuePtr& key);
+    std::size_t size() const { return count; }
+    std::vector<ValuePtr> keys() const;
+    std::vector<std::pair<ValuePtr, ValuePtr>> entries() const;
+
+private:
+    struct Slot {
+        ValuePtr key;
+        ValuePtr value;
+        std::size_t hash = 0;
+        std::int32_t distance = -1;  // 距理想位置的探测距离，-1 表示空槽
+    };
+
+    std::vector<Slot> slots;
+    std::size_t count = 0;
+
+    std::size_t mask() const { return slots.size() - 1; }
+    std::size_t findIndex(const ValuePtr& key, std::size_t hash) const;
+    void grow();
+    void place(Slot slot);
+};
+
+#endif
@@ -0,0 +1,453 @@
+#include "./image.h"
+#include "./error.h"
+#include "./fasl.h"
+#include "./forms.h"
+#include "./hash_table.h"
+#include "./matrix.h"
+#include "./rational.h"
+#include "./vector_value.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+constexpr char IMAGE_MAGIC[8] = {'M', 'L', 'I', 'M', 'A', 'G', '0', '6'};
+constexpr std::uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+constexpr std::uint32_t NO_PARENT = 0xffffffff;
+
+enum ImageTag : std::uint8_t {
+    IMAGE_BUILTIN = FASL_EXTENDED,
+    IMAGE_LAMBDA,
+    IMAGE_RATIONAL,
+    IMAGE_MATRIX,
+    IMAGE_HASH_TABLE,
+    IMAGE_PAIR,
+    IMAGE_VECTOR,
+};
+
+// 镜像数据区布局：
+//   环境表（每项为父环境下标，父环境总在子环境之前）
+//   哈希表个数、对子个数、各向量的长度
+//   闭包表（名字、参数、过程体、所在环境下标）
+//   各对子的 car 与 cdr、各向量的元素、各哈希表的内容
+//   各环境的绑定（名字与值，闭包、哈希表、对子与向量按下标引用）
+//   附带的值
+// 先建好全部环境、闭包、空哈希表、对子与向量再填内容，循环引用与共享因此无需特殊处理；
+// 哈希表的键按内容计算哈希，所以最后填哈希表。过程体是代码，仍按值展开。
+// 不带全局绑定时，全局环境只占一个下标，读入时对应到接收方的全局环境。
+class ImageWriter : public FaslWriter {
+public:
+    ImageWriter(const EvalEnv& root, bool withGlobals) : root(root), withGlobals(withGlobals) {}
+    void save(const std::vector<ValuePtr>& values);
+
+protected:
+    void writeExtended(const ValuePtr& value) override;
+    bool isReference(const Value& value) const override;
+
+private:
+    const EvalEnv& root;
+    bool withGlobals;
+    std::vector<const EvalEnv*> envs;
+    std::unordered_map<const EvalEnv*, std::uint32_t> envIndex;
+    std::vector<std::shared_ptr<LambdaValue>> lambdas;
+    std::unordered_map<const Value*, std::uint32_t> lambdaIndex;
+    std::vector<const HashTableValue*> tables;
+    std::unordered_map<const Value*, std::uint32_t> tableIndex;
+    std::vector<const PairValue*> pairs;
+    std::unordered_map<const Value*, std::uint32_t> pairIndex;
+    std::vector<const VectorValue*> vectors;
+    std::unordered_map<const Value*, std::uint32_t> vectorIndex;
+    std::vector<const EvalEnv*> pending;
+    std::unordered_set<const Value*> transferable;
+
+    void addEnv(const EvalEnv* env);
+    void collect(const ValuePtr& value);
+    bool isTransferable(const ValuePtr& value);
+    bool reachTransferable(const ValuePtr& value, std::unordered_set<const Value*>& visited) const;
+    bool isOriginalBuiltin(const std::string& name, const ValuePtr& value) const;
+};
+
+void ImageWriter::addEnv(const EvalEnv* env) {
+    if (envIndex.contains(env)) return;
+    if (env != &root) {
+        if (auto parent = env->getParent()) addEnv(parent.get());
+    }
+    envIndex[env] = static_cast<std::uint32_t>(envs.size());
+    envs.push_back(env);
+    pending.push_back(env);
+}
+
+// 对子与向量第一次遇到时编号，再次遇到说明是共享的结构或走回了环上，不再深入
+void ImageWriter::collect(const ValuePtr& value) {
+    ValuePtr current = value;
+    while (current->isPair() && !pairIndex.contains(current.get())) {
+        auto pair = static_cast<const PairValue*>(current.get());
+        pairIndex[pair] = static_cast<std::uint32_t>(pairs.size());
+        pairs.push_back(pair);
+        collect(pair->getCar());
+        current = pair->getCdr();
+    }
+    if (current->isVector() && !vectorIndex.contains(current.get())) {
+        auto vector = static_cast<const VectorValue*>(current.get());
+        vectorIndex[vector] = static_cast<std::uint32_t>(vectors.size());
+        vectors.push_back(vector);
+        for (const auto& element : vector->getElements()) collect(element);
+    }
+    if (typeid(*current) == typeid(LambdaValue) && !lambdaIndex.contains(current.get())) {
+        auto lambda = std::dynamic_pointer_cast<LambdaValue>(current);
+        lambdaIndex[current.get()] = static_cast<std::uint32_t>(lambdas.size());
+        lambdas.push_back(lambda);
+        addEnv(lambda->getEnv().get());
+    }
+    if (current->isHashTable() && !tableIndex.contains(current.get())) {
+        auto table = static_cast<const HashTableValue*>(current.get());
+        tableIndex[table] = static_cast<std::uint32_t>(tables.size());
+        tables.push_back(table);
+        for (const auto& [key, value] : table->entries()) {
+            collect(key);
+            collect(value);
+        }
+    }
+}
+
+// 值本身及其中的表、向量、哈希表都不含进程内句柄时才可复制。
+// 闭包总是可复制：其环境中的绑定写入时逐个检查。
+// 只有整体可复制时才记住走过的值；中途失败时环中已走过的值未必可复制。
+bool ImageWriter::isTransferable(const ValuePtr& value) {
+    std::unordered_set<const Value*> visited;
+    if (!reachTransferable(value, visited)) return false;
+    transferable.insert(visited.begin(), visited.end());
+    return true;
+}
+
+bool ImageWriter::reachTransferable(const ValuePtr& value, std::unordered_set<const Value*>& visited) const {
+    ValuePtr current = value;
+    while (true) {
+        if (transferable.contains(current.get()) || !visited.insert(current.get()).second) return true;
+        if (!current->isTransferable()) return false;
+        if (!current->isPair()) break;
+        if (!reachTransferable(current->CAR(), visited)) return false;
+        current = current->CDR();
+    }
+    if (current->isVector()) {
+        for (const auto& element : static_cast<const VectorValue&>(*current).getElements()) {
+            if (!reachTransferable(element, visited)) return false;
+        }
+    }
+    if (current->isHashTable()) {
+        for (const auto& [key, value] : static_cast<const HashTableValue&>(*current).entries()) {
+            if (!reachTransferable(key, visited) || !reachTransferable(value, visited)) return false;
+        }
+    }
+    return true;
+}
+
+// 全局环境中未被改绑的内置过程在新环境里本来就有，无需写入镜像
+bool ImageWriter::isOriginalBuiltin(const std::string& name, const ValuePtr& value) const {
+    auto builtin = dynamic_cast<const BuiltinProcValue*>(value.get());
+    return builtin && builtin->getName() == name;
+}
+
+void ImageWriter::save(const std::vector<ValuePtr>& values) {
+    addEnv(&root);
+    if (!withGlobals) pending.clear();
+    for (const auto& value : values) collect(value);
+    while (!pending.empty()) {
+        auto env = pending.back();
+        pending.pop_back();
+        for (const auto& [name, value] : env->getBindings()) {
+            if (isTransferable(value)) collect(value);
+        }
+    }
+
+    writeU32(static_cast<std::uint32_t>(envs.size()));
+    for (auto env : envs) {
+        auto parent = env == &root ? nullptr : env->getParent();
+        writeU32(parent ? envIndex.at(parent.get()) : NO_PARENT);
+    }
+
+    writeU32(static_cast<std::uint32_t>(tables.size()));
+    writeU32(static_cast<std::uint32_t>(pairs.size()));
+    writeU32(static_cast<std::uint32_t>(vectors.size()));
+    for (auto vector : vectors) writeU32(static_cast<std::uint32_t>(vector->size()));
+
+    writeU32(static_cast<std::uint32_t>(lambdas.size()));
+    for (const auto& lambda : lambdas) {
+        writeBytes(lambda->getName());
+        writeU32(static_cast<std::uint32_t>(lambda->getParams().size()));
+        for (const auto& param : lambda->getParams()) writeBytes(param);
+        writeU32(static_cast<std::uint32_t>(lambda->getBody().size()));
+        for (const auto& expr : lambda->getBody()) writeValue(expr);
+        writeU32(envIndex.at(lambda->getEnv().get()));
+    }
+
+    for (auto pair : pairs) {
+        writeValue(pair->getCar());
+        writeValue(pair->getCdr());
+    }
+    for (auto vector : vectors) {
+        for (const auto& element : vector->getElements()) writeValue(element);
+    }
+
+    for (auto table : tables) {
+        auto entries = table->entries();
+        writeU32(static_cast<std::uint32_t>(entries.size()));
+        for (const auto& [key, value] : entries) {
+            writeValue(key);
+            writeValue(value);
+        }
+    }
+
+    for (auto env : envs) {
+        std::vector<std::pair<std::string, ValuePtr>> bindings;
+        for (const auto& [name, value] : env->getBindings()) {
+            if (env == &root && (!withGlobals || isOriginalBuiltin(name, value))) continue;
+            // 绑定到进程内句柄的名字不复制
+            if (!isTransferable(value)) continue;
+            bindings.emplace_back(name, value);
+        }
+        writeU32(static_cast<std::uint32_t>(bindings.size()));
+        for (const auto& [name, value] : bindings) {
+            writeBytes(name);
+            writeValue(value);
+        }
+    }
+
+    writeU32(static_cast<std::uint32_t>(values.size()));
+    for (const auto& value : values) writeValue(value);
+}
+
+bool ImageWriter::isReference(const Value& value) const {
+    return pairIndex.contains(&value) || vectorIndex.contains(&value);
+}
+
+void ImageWriter::writeExtended(const ValuePtr& value) {
+    if (auto index = pairIndex.find(value.get()); index != pairIndex.end()) {
+        writeU8(IMAGE_PAIR);
+        writeU32(index->second);
+    } else if (auto index = vectorIndex.find(value.get()); index != vectorIndex.end()) {
+        writeU8(IMAGE_VECTOR);
+        writeU32(index->second);
+    } else if (auto builtin = dynamic_cast<const BuiltinProcValue*>(value.get())) {
+        if (builtin->getName().empty()) {
+            throw LispError("Cannot save an anonymous builtin procedure in an image");
+        }
+        writeU8(IMAGE_BUILTIN);
+        writeBytes(builtin->getName());
+    } else if (typeid(*value) == typeid(LambdaValue)) {
+        writeU8(IMAGE_LAMBDA);
+        writeU32(lambdaIndex.at(value.get()));
+    } else if (value->isHashTable()) {
+        writeU8(IMAGE_HASH_TABLE);
+        writeU32(tableIndex.at(value.get()));
+    } else if (value->isRational()) {
+        auto& rational = static_cast<const RationalValue&>(*value);
+        writeU8(IMAGE_RATIONAL);
+        writeU32(static_cast<std::uint32_t>(rational.getNumerator()));
+        writeU32(static_cast<std::uint32_t>(rational.getDenominator()));
+    } else if (value->isMatrix()) {
+        auto element = static_cast<const MatrixValue&>(*value).getElement();
+        writeU8(IMAGE_MATRIX);
+        writeU32(static_cast<std::uint32_t>(value->getrows()));
+        writeU32(static_cast<std::uint32_t>(value->getcols()));
+        for (const auto& row : element) {
+            for (double x : row) writeDouble(x);
+        }
+    } else {
+        FaslWriter::writeExtended(value);
+    }
+}
+
+class ImageReader : public FaslReader {
+public:
+    using FaslReader::FaslReader;
+    // root 为空时新建全局环境，否则把镜像中的全局环境对应到 root
+    std::shared_ptr<EvalEnv> load(std::shared_ptr<EvalEnv> root, std::vector<ValuePtr>& values);
+
+protected:
+    ValuePtr readExtended(std::uint8_t tag) override;
+
+private:
+    std::unordered_map<std::string, ValuePtr> builtins;
+    std::vector<std::shared_ptr<EvalEnv>> envs;
+    std::vector<ValuePtr> lambdas;
+    std::vector<std::shared_ptr<HashTableValue>> tables;
+    std::vector<std::shared_ptr<PairValue>> pairs;
+    std::vector<std::shared_ptr<VectorValue>> vectors;
+};
+
+std::shared_ptr<EvalEnv> ImageReader::load(std::shared_ptr<EvalEnv> root, std::vector<ValuePtr>& values) {
+    readSymbolTable();
+    if (!root) root = std::shared_ptr<EvalEnv>{new EvalEnv};
+    // 只认仍绑定在原名下的内置过程，用户改绑过的名字按内置过程表重建
+    for (const auto& [name, value] : root->getBindings()) {
+        auto builtin = dynamic_cast<const BuiltinProcValue*>(value.get());
+        if (builtin && builtin->getName() == name) builtins.emplace(name, value);
+    }
+
+    auto envCount = readCount(sizeof(std::uint32_t));
+    for (std::uint32_t i = 0; i < envCount; i++) {
+        auto parent = readU32();
+        if (i == 0) {
+            envs.push_back(root);
+        } else if (parent == NO_PARENT) {
+            envs.push_back(std::shared_ptr<EvalEnv>{new EvalEnv});
+        } else if (parent < i) {
+            envs.push_back(envs[parent]->createChild({}, {}));
+        } else {
+            throw FileError("Corrupted image: bad environment parent");
+        }
+    }
+
+    tables.resize(readCount(sizeof(std::uint32_t)));
+    for (auto& table : tables) table = std::make_shared<HashTableValue>();
+    pairs.resize(readCount(2));
+    for (auto& pair : pairs) pair = std::make_shared<PairValue>(nullptr, nullptr);
+    vectors.resize(readCount(sizeof(std::uint32_t)));
+    for (auto& vector : vectors) vector = std::make_shared<VectorValue>(std::vector<ValuePtr>(readCount()));
+
+    auto lambdaCount = readCount(sizeof(std::uint32_t));
+    for (std::uint32_t i = 0; i < lambdaCount; i++) {
+        auto name = readBytes();
+        std::vector<std::string> params(readCount(sizeof(std::uint32_t)));
+        for (auto& param : params) param = readBytes();
+        std::vector<ValuePtr> body(readCount());
+        for (auto& expr : body) expr = readValue();
+        auto env = readU32();
+        if (env >= envs.size()) throw FileError("Corrupted image: bad closure environment");
+        auto lambda = std::make_shared<LambdaValue>(params, body, envs[env]);
+        lambda->setName(name);
+        lambdas.push_back(lambda);
+    }
+
+    for (const auto& pair : pairs) {
+        pair->setCar(readValue());
+        pair->setCdr(readValue());
+    }
+    for (const auto& vector : vectors) {
+        for (auto& element : vector->getElements()) element = readValue();
+    }
+
+    for (const auto& table : tables) {
+        auto count = readCount(2);
+        for (std::uint32_t i = 0; i < count; i++) {
+            auto key = readValue();
+            table->insert(key, readValue());
+        }
+    }
+
+    for (const auto& env : envs) {
+        auto count = readCount(sizeof(std::uint32_t) + 1);
+        for (std::uint32_t i = 0; i < count; i++) {
+            auto name = readBytes();
+            env->defineBinding(name, readValue());
+        }
+    }
+
+    values.resize(readCount());
+    for (auto& value : values) value = readValue();
+    if (!atEnd()) throw FileError("Corrupted image: trailing data");
+    return root;
+}
+
+ValuePtr ImageReader::readExtended(std::uint8_t tag) {
+    switch (tag) {
+        case IMAGE_BUILTIN: {
+            auto name = readBytes();
+            auto it = builtins.find(name);
+            if (it != builtins.end()) return it->second;
+            auto proc = builtinProcs.find(name);
+            if (proc == builtinProcs.end()) throw FileError("Image refers to unknown builtin " + name);
+            return std::make_shared<BuiltinProcValue>(proc->second, name);
+        }
+        case IMAGE_LAMBDA: {
+            auto index = readU32();
+            if (index >= lambdas.size()) throw FileError("Corrupted image: bad closure index");
+            return lambdas[index];
+        }
+        case IMAGE_PAIR: {
+            auto index = readU32();
+            if (index >= pairs.size()) throw FileError("Corrupted image: bad pair index");
+            return pairs[index];
+        }
+        case IMAGE_VECTOR: {
+            auto index = readU32();
+            if (index >= vectors.size()) throw FileError("Corrupted image: bad vector index");
+            return vectors[index];
+        }
+        case IMAGE_HASH_TABLE: {
+            auto index = readU32();
+            if (index >= tables.size()) throw FileError("Corrupted image: bad hash table index");
+            return tables[index];
+        }
+        case IMAGE_RATIONAL: {
+            auto numerator = static_cast<int>(readU32());
+            auto denominator = static_cast<int>(readU32());
+            return std::make_shared<RationalValue>(numerator, denominator);
+        }
+        case IMAGE_MATRIX: {
+            auto rows = readCount(sizeof(double));
+            auto cols = readCount(std::max<std::size_t>(rows, 1) * sizeof(double));
+            std::vector<std::vector<double>> element(rows, std::vector<double>(cols));
+            for (auto& row : element) {
+                for (auto& x : row) x = readDouble();
+            }
+            return std::make_shared<MatrixValue>(element);
+        }
+        default: return FaslReader::readExtended(tag);
+    }
+}
+
+}  // namespace
+
+void saveImage(const std::string& path, EvalEnv& env) {
+    ImageWriter writer(env, true);
+    writer.save({});
+    FaslWriter header;
+    for (char c : IMAGE_MAGIC) header.writeU8(static_cast<std::uint8_t>(c));
+    header.writeU32(IMAGE_BYTE_ORDER);
+    std::string data = header.raw() + writer.finish();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileError("Cannot write image " + path);
+    }
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out) {
+        throw FileError("Cannot write image " + path);
+    }
+}
+
+std::shared_ptr<EvalEnv> loadImage(const std::string& path) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        throw FileError("Image not found: " + path);
+    }
+    ImageReader reader(file.data(), file.data() + file.size());
+    char magic[sizeof(IMAGE_MAGIC)];
+    for (auto& c : magic) c = static_cast<char>(reader.readU8());
+    if (std::memcmp(magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 ||
+        reader.readU32() != IMAGE_BYTE_ORDER) {
+        throw FileError("Not a mini-lisp image: " + path);
+    }
+    std::vector<ValuePtr> values;
+    return reader.load(nullptr, values);
+}
+
+std::string serializeValues(EvalEnv& root, const std::vector<ValuePtr>& values, bool withGlobals) {
+    ImageWriter writer(root, withGlobals);
+    writer.save(values);
+    return writer.finish();
+}
+
+std::vector<ValuePtr> deserializeValues(const std::string& data, std::shared_ptr<EvalEnv>& root) {
+    ImageReader reader(data.data(), data.data() + data.size());
+    std::vector<ValuePtr> values;
+    root = reader.load(root, values);
+    return values;
+}
@@ -0,0 +1,21 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./eval_env.h"
+
+// 堆镜像：把全局环境（绑定、闭包及其环境链、常量）写成与地址无关的镜像文件，
+// 启动时映射镜像即可恢复环境，无需重新执行预加载脚本。
+void saveImage(const std::string& path, EvalEnv& env);
+std::shared_ptr<EvalEnv> loadImage(const std::string& path);
+
+// 在 isolate 之间复制值：闭包连同其局部环境链一起复制。withGlobals 为真时还复制 root 中的全局绑定；
+// 否则闭包引用的全局环境在还原时对应到接收方传入的 root。
+// 还原时 root 为空则新建全局环境并通过 root 返回。
+std::string serializeValues(EvalEnv& root, const std::vector<ValuePtr>& values, bool withGlobals);
+std::vector<ValuePtr> deserializeValues(const std::string& data, std::shared_ptr<EvalEnv>& root);
+
+#endif
@@ -0,0 +1,132 @@
+#include "./isolate.h"
+#include "./error.h"
+#include "./image.h"
+
+namespace {
+
+// 当前线程所在的 isolate，主线程为空
+thread_local IsolateValue::State* currentIsolate = nullptr;
+
+IsolateValue& asIsolate(const ValuePtr& value, const std::string& procName) {
+    auto isolate = dynamic_cast<IsolateValue*>(value.get());
+    if (!isolate) throw LispError(procName + " expects an isolate as its first argument.");
+    return *isolate;
+}
+
+ValuePtr decode(const std::string& data, EvalEnv& env) {
+    auto root = env.shared_from_this();
+    return deserializeValues(data, root).at(0);
+}
+
+}  // namespace
+
+void Mailbox::send(std::string message) {
+    {
+        std::lock_guard lock(mutex);
+        messages.push_back(std::move(message));
+    }
+    ready.notify_one();
+}
+
+std::optional<std::string> Mailbox::receive() {
+    std::unique_lock lock(mutex);
+    ready.wait(lock, [this] { return closed || !messages.empty(); });
+    if (messages.empty()) return std::nullopt;
+    auto message = std::move(messages.front());
+    messages.pop_front();
+    return message;
+}
+
+void Mailbox::close() {
+    {
+        std::lock_guard lock(mutex);
+        closed = true;
+    }
+    ready.notify_all();
+}
+
+IsolateValue::IsolateValue(EvalEnv& env, const ValuePtr& proc, const std::vector<ValuePtr>& args)
+    : state(std::make_shared<State>()) {
+    // 在创建者线程中序列化，新线程只接触自己还原出的副本
+    std::vector<ValuePtr> values{proc};
+    values.insert(values.end(), args.begin(), args.end());
+    auto snapshot = serializeValues(env, values, true);
+    thread = std::thread([state = state, snapshot = std::move(snapshot)] {
+        currentIsolate = state.get();
+        try {
+            std::shared_ptr<EvalEnv> root;
+            auto values = deserializeValues(snapshot, root);
+            std::vector<ValuePtr> args(values.begin() + 1, values.end());
+            auto result = root->apply(values[0], args);
+            state->result = serializeValues(*root, {result}, false);
+        } catch (std::exception& e) {
+            state->error = e.what();
+        }
+        state->outbox.close();
+    });
+}
+
+IsolateValue::~IsolateValue() {
+    // 创建者不再持有 isolate 时，关闭收件箱让仍在等待消息的 isolate 结束
+    state->inbox.close();
+    if (thread.joinable()) thread.detach();
+}
+
+void IsolateValue::send(EvalEnv& env, const ValuePtr& message) {
+    state->inbox.send(serializeValues(env, {message}, false));
+}
+
+ValuePtr IsolateValue::receive(EvalEnv& env) {
+    auto message = state->outbox.receive();
+    if (!message) throw LispError("isolate-receive: the isolate has finished.");
+    return decode(*message, env);
+}
+
+ValuePtr IsolateValue::join(EvalEnv& env) {
+    std::lock_guard lock(joinMutex);
+    if (thread.joinable()) {
+        thread.join();
+        if (state->error.empty()) result = decode(state->result, env);
+    }
+    if (!state->error.empty()) throw LispError("Isolate failed: " + state->error);
+    return result;
+}
+
+ValuePtr isolateSpawn(const std::vector<ValuePtr>& params, EvalEnv& env) {
+    if (params.empty() || !params[0]->isProcedure()) {
+        throw LispError("isolate-spawn expects a procedure.");
+    }
+    std::vector<ValuePtr> args(params.begin() + 1, params.end());
+    return std::make_shared<IsolateValue>(env, params[0], args);
+}
+
+ValuePtr isolateSend(const std::vector<ValuePtr>& params, EvalEnv& env) {
+    if (params.size() == 1) {
+        if (!currentIsolate) throw LispError("isolate-send with one argument must be called inside an isolate.");
+        currentIsolate->outbox.send(serializeValues(env, {params[0]}, false));
+    } else if (params.size() == 2) {
+        asIsolate(params[0], "isolate-send").send(env, params[1]);
+    } else {
+        throw LispError("isolate-send expects one or two arguments.");
+    }
+    return std::make_shared<NilValue>();
+}
+
+ValuePtr isolateReceive(const std::vector<ValuePtr>& params, EvalEnv& env) {
+    if (params.empty()) {
+        if (!currentIsolate) throw LispError("isolate-receive without arguments must be called inside an isolate.");
+        auto message = currentIsolate->inbox.receive();
+        if (!message) throw LispError("isolate-receive: the creator has gone away.");
+        return decode(*message, env);
+    } else if (params.size() == 1) {
+        return asIsolate(params[0], "isolate-receive").receive(env);
+    }
+    throw LispError("isolate-receive expects zero or one argument.");
+}
+
+ValuePtr isolateJoin(const std::vector<ValuePtr>& params, EvalEnv& env) {
+    if (params.size() != 1) {
+        throw LispError("isolate-join expects exactly one argument.");
+    }
+    return asIsolate(params[0], "isolate-join").join(env);
+}
@@ -0,0 +1,66 @@
+#ifndef ISOLATE_H
+#define ISOLATE_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "./eval_env.h"
+#include "./value.h"
+
+// 线程间传递序列化消息的阻塞队列
+class Mailbox {
+public:
+    void send(std::string message);
+    // 队列为空时等待；已关闭且为空时返回空
+    std::optional<std::string> receive();
+    void close();
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::string> messages;
+    bool closed = false;
+};
+
+// isolate：在独立线程上运行、拥有独立全局环境的解释器实例。
+// 启动时复制创建者的全局环境，之后只通过消息（同样是复制）与创建者通信。
+class IsolateValue : public Value {
+public:
+    struct State {
+        Mailbox inbox;   // 创建者发给 isolate
+        Mailbox outbox;  // isolate 发给创建者
+        std::string result;
+        std::string error;
+    };
+
+    IsolateValue(EvalEnv& env, const ValuePtr& proc, const std::vector<ValuePtr>& args);
+    ~IsolateValue();
+    std::string toString() const override { return "#<isolate>"; }
+    bool isTransferable() const override { return false; }
+
+    void send(EvalEnv& env, const ValuePtr& message);
+    ValuePtr receive(EvalEnv& env);
+    ValuePtr join(EvalEnv& env);
+
+private:
+    std::shared_ptr<State> state;
+    std::thread thread;
+    std::mutex joinMutex;
+    ValuePtr result;
+};
+
+// (isolate-spawn proc arg ...)
+ValuePtr isolateSpawn(const std::vector<ValuePtr>& params, EvalEnv& env);
+// (isolate-send isolate message)，在 isolate 内部为 (isolate-send message)
+ValuePtr isolateSend(const std::vector<ValuePtr>& params, EvalEnv& env);
+// (isolate-receive isolate)，在 isolate 内部为 (isolate-receive)
+ValuePtr isolateReceive(const std::vector<ValuePtr>& params, EvalEnv& env);
+// (isolate-join isolate)
+ValuePtr isolateJoin(const std::vector<ValuePtr>& params, EvalEnv& env);
+
+#endif
@@ -6,7 +6,12 @@
 #include "./parser.h"
 #include "./eval_env.h"
 #include "./forms.h"
+#include "./image.h"
+#include "./eval_limits.h"
+#include "./profiler.h"
 #include "./read.h"
+#include "./server.h"
+#include "./stats.h"
 #include "./rational.h"
 
 #include "rjsj_test.hpp"
@@ -22,19 +27,99 @@ struct TestCtx {
     }
 };
 
+void printUsage() {
+    std::cout << "usage : mini_lisp [options] [file...]" << std::endl
+              << "  --image <file>       load a heap image before running" << std::endl
+              << "  --save-image <file>  save the global environment after running files" << std::endl
+              << "  --serve <socket>     serve evaluation requests on a Unix domain socket" << std::endl
+              << "  --profile            sample Lisp call stacks and print a report on exit" << std::endl
+              << "  --profile-folded <file>  also write folded stacks for flame graph tools" << std::endl
+              << "  --stats              count evaluations, frames and allocations and print them on exit" << std::endl
+              << "  --max-steps <n>      raise an error after n evaluation steps" << std::endl
+              << "  --max-depth <n>      raise an error when evaluation nests deeper than n" << std::endl
+              << "  --max-heap <bytes>   raise an error when live heap memory exceeds the given size" << std::endl;
+}
+
 int main(int argc, char** argv) {
-    //RJSJ_TEST(TestCtx, Lv2, Lv3, Lv4, Lv5, Lv5Extra, Lv6, Lv7, Lv7Lib, Sicp);
-    //usage : ./mini_lisp (filename)
-    switch (argc) {
-        case 1 : 
-            REPLmode();
-            break;
-        case 2 :
-            filemode(argv[1]);
-            break;
-        default :
-            std::cout << "usage : mini_lisp [file]" << std::endl;
-            break;    
+    //RJSJ_TEST(TestCtx, Lv2, Lv3, Lv4, Lv5, Lv5Extra, Lv6, Lv7, Lv7Lib, Sicp, Tooling, Data, Iteration, Parallel, Streams, Optimize);
+    //usage : ./mini_lisp [options] [file...]
+    std::string imagePath;
+    std::string saveImagePath;
+    std::string socketPath;
+    std::vector<std::string> files;
+    bool profile = false;
+    std::string foldedPath;
+    bool stats = false;
+    std::uint64_t maxSteps = 0;
+    std::uint64_t maxDepth = 0;
+    std::int64_t maxHeap = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--image" && i + 1 < argc) {
+            imagePath = argv[++i];
+        } else if (arg == "--save-image" && i + 1 < argc) {
+            saveImagePath = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--profile-folded" && i + 1 < argc) {
+            profile = true;
+            foldedPath = argv[++i];
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if ((arg == "--max-steps" || arg == "--max-depth" || arg == "--max-heap") && i + 1 < argc) {
+            try {
+                auto value = std::stoull(argv[++i]);
+                if (arg == "--max-steps") maxSteps = value;
+                else if (arg == "--max-depth") maxDepth = value;
+                else maxHeap = static_cast<std::int64_t>(value);
+            } catch (std::exception&) {
+                printUsage();
+                return 1;
+            }
+        } else if (arg.starts_with("--")) {
+            printUsage();
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (profile) startProfiler(foldedPath);
+    if (stats) startStats(true);
+    setStepLimit(maxSteps);
+    setDepthLimit(maxDepth);
+    setHeapLimit(maxHeap);
+
+    if (imagePath.empty() && saveImagePath.empty() && socketPath.empty()) {
+        switch (files.size()) {
+            case 0 :
+                REPLmode();
+                break;
+            case 1 :
+                filemode(files[0]);
+                break;
+            default :
+                printUsage();
+                break;
+        }
+        return 0;
+    }
+
+    try {
+        auto env = imagePath.empty() ? std::shared_ptr<EvalEnv>{new EvalEnv} : loadImage(imagePath);
+        for (const auto& file : files) loadFile(file, *env);
+        if (!saveImagePath.empty()) {
+            saveImage(saveImagePath, *env);
+        } else if (!socketPath.empty()) {
+            serve(socketPath, env);
+        } else if (files.empty()) {
+            REPLmode(env);
+        }
+    } catch (std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
     return 0;
 }
@@ -1,5 +1,6 @@
 #include "./matrix.h"
 #include "./error.h"
+#include <cmath>
 
 MatrixValue::MatrixValue() : rows(0) , cols(0) {}
 
@@ -16,7 +17,7 @@ MatrixValue::MatrixValue(std::vector<std::vector<double>> element) : element(ele
 }
 
 MatrixValue::MatrixValue(const MatrixValue& other)
-    : rows(other.rows), cols(other.cols), element(other.rows, std::vector<double>(other.cols))
+    : Value(), element(other.rows, std::vector<double>(other.cols)), rows(other.rows), cols(other.cols)
 {
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
@@ -175,19 +176,17 @@ MatrixValue MatrixValue::sub(int row, int col){
 
     MatrixValue subMatrix(subRows, subCols);
 
-    int subRow = -1;
-    int subCol = -1;
+    int subRow = 0;
     for(int i = 0; i < rows; i++){
         if(i != row){
-            subRow++;
+            int subCol = 0;
             for(int j = 0; j < cols; j++){
                 if(j != col){
-                    subCol++;
                     subMatrix.element[subRow][subCol] = element[i][j];
-                    subCol--;
+                    subCol++;
                 }
             }
-            subRow--;
+            subRow++;
         }
     }
     return subMatrix;
@@ -248,7 +247,7 @@ MatrixValue MatrixValue::inverse() {
     if (rows != cols) {
         throw MathError("Matrix must be square for inverse.");
     }
-    int det = this->det();
+    double det = this->det();
     if (det == 0) {
         throw MathError("Matrix is singular and cannot be inverted.");
     }
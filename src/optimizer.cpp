@@ -0,0 +1,545 @@
+#include "./optimizer.h"
+#include "./error.h"
+#include "./forms.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+
+std::atomic<std::uint64_t> foldEpoch{0};
+
+namespace {
+
+// 折叠或内联时依赖过的名字各有一个版本号。表项只增不删，版本号的地址一直有效
+std::shared_mutex versionsMutex;
+std::unordered_map<std::string, std::unique_ptr<std::atomic<std::uint64_t>>> versions;
+
+// 有版本号的名字按哈希记在位图中，修改其他名字的绑定时不必查表。
+// 不同名字可能落在同一位，代价只是多查一次表
+constexpr std::size_t WATCH_BITS = 4096;
+std::atomic<std::uint64_t> watchedNames[WATCH_BITS / 64];
+
+// 开关跟踪对应的版本号，内联过过程的过程体都依赖它。括号保证它不会与符号重名
+const std::string TRACING = "(trace)";
+
+std::atomic<std::uint64_t>& watchWord(const std::string& name, std::uint64_t& bit) {
+    auto hash = std::hash<std::string>{}(name) % WATCH_BITS;
+    bit = std::uint64_t{1} << (hash % 64);
+    return watchedNames[hash / 64];
+}
+
+const std::atomic<std::uint64_t>* versionOf(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(versionsMutex);
+        auto it = versions.find(name);
+        if (it != versions.end()) return it->second.get();
+    }
+    std::unique_lock<std::shared_mutex> lock(versionsMutex);
+    auto& version = versions[name];
+    if (!version) {
+        version = std::make_unique<std::atomic<std::uint64_t>>(0);
+        std::uint64_t bit;
+        watchWord(name, bit).fetch_or(bit);
+    }
+    return version.get();
+}
+
+void bump(const std::string& name) {
+    std::uint64_t bit;
+    if (!(watchWord(name, bit).load() & bit)) return;
+    {
+        std::shared_lock<std::shared_mutex> lock(versionsMutex);
+        auto it = versions.find(name);
+        if (it == versions.end()) return;
+        it->second->fetch_add(1);
+    }
+    foldEpoch.fetch_add(1);
+}
+
+// 内联的过程体最多包含的结点数与嵌套内联的层数
+constexpr int MAX_INLINE_SIZE = 24;
+constexpr std::size_t MAX_INLINE_DEPTH = 3;
+
+// 内联的过程体中不能出现的形式：它们会绑定名字、保存环境或推迟求值
+const std::unordered_set<std::string> NON_INLINABLE_FORMS{
+    "lambda", "define", "set!", "let", "let*", "letrec", "do", "delay", "cons-stream", "future",
+    "quasiquote", "load-file", "read-line", "time", "trace", "untrace",
+};
+
+// 含有这些形式时，实参可能不被求值或求值次数不定
+const std::unordered_set<std::string> CONDITIONAL_FORMS{"if", "cond", "and", "or"};
+
+// 结果只取决于参数、没有副作用且不新建可修改对象的内置过程
+const std::unordered_set<std::string> PURE_BUILTINS{
+    "+", "-", "*", "/", "abs", "expt", "round", "quotient", "modulo", "remainder",
+    "=", "<", ">", "<=", ">=", "even?", "odd?", "zero?", "max", "min", "not",
+    "eq?", "eqv?", "equal?", "car", "cdr", "length",
+    "atom?", "boolean?", "integer?", "list?", "number?", "null?", "pair?", "string?", "symbol?",
+    "number->string", "string->number", "string-length", "string-ref", "substring", "string-append",
+};
+
+// 过程体中的表达式保存到过程返回之后，折叠后便脱离了本过程的失效检查，不进入其中
+const std::unordered_set<std::string> OPAQUE_FORMS{
+    "quote", "quasiquote", "lambda", "delay", "cons-stream", "future",
+};
+
+bool isSymbol(const ValuePtr& value, const char* name) {
+    auto symbol = value->asSymbol();
+    return symbol && *symbol == name;
+}
+
+void addName(const ValuePtr& value, std::unordered_set<std::string>& bound) {
+    if (auto name = value->asSymbol()) bound.insert(*name);
+}
+
+void addNames(ValuePtr list, std::unordered_set<std::string>& bound) {
+    while (list->isPair()) {
+        addName(list->CAR(), bound);
+        list = list->CDR();
+    }
+    addName(list, bound);
+}
+
+// 收集过程体中被重新绑定或赋值的名字：lambda 参数、define、let 系列与 do 的变量、set! 的目标
+void collectBound(const ValuePtr& expr, std::unordered_set<std::string>& bound) {
+    if (!expr->isPair()) return;
+    const auto& head = expr->CAR();
+    if (isSymbol(head, "quote") || isSymbol(head, "quasiquote")) return;
+    auto args = expr->CDR();
+    if (args->isPair()) {
+        auto first = args->CAR();
+        if (isSymbol(head, "lambda")) {
+            addNames(first, bound);
+        } else if (isSymbol(head, "define")) {
+            if (first->isPair()) addNames(first, bound);
+            else addName(first, bound);
+        } else if (isSymbol(head, "set!")) {
+            addName(first, bound);
+        } else if (isSymbol(head, "let") || isSymbol(head, "let*") || isSymbol(head, "letrec") ||
+                   isSymbol(head, "do")) {
+            if (first->asSymbol() && args->CDR()->isPair()) {
+                addName(first, bound);
+                first = args->CDR()->CAR();
+            }
+            for (ValuePtr binding = first; binding->isPair(); binding = binding->CDR()) {
+                if (binding->CAR()->isPair()) addName(binding->CAR()->CAR(), bound);
+            }
+        }
+    }
+    for (ValuePtr current = expr; current->isPair(); current = current->CDR()) {
+        collectBound(current->CAR(), bound);
+    }
+}
+
+bool isConstant(const ValuePtr& expr) {
+    return expr->isSelfEvaluating() || (expr->isPair() && isSymbol(expr->CAR(), "quote") &&
+                                        expr->CDR()->isPair() && expr->CDR()->CDR()->isNil());
+}
+
+// 名字是否绑定在全局环境以外的某层环境中
+bool boundLocally(const std::string& name, const EvalEnv& env) {
+    for (auto current = &env; current->getParent(); current = current->getParent().get()) {
+        if (current->findLocal(name)) return true;
+    }
+    return false;
+}
+
+// 找到名字所在的环境；不在全局环境中时 global 为假
+ValuePtr findBinding(const std::string& name, EvalEnv& env, bool& global) {
+    for (auto current = env.shared_from_this(); current; current = current->getParent()) {
+        if (auto value = current->findLocal(name)) {
+            global = !current->getParent();
+            return value;
+        }
+    }
+    return nullptr;
+}
+
+// 全局环境中绑定的、可以内联的过程：过程体只有一个表达式且定义在全局环境中，没有被跟踪
+const LambdaValue* inlineCandidate(const std::string& name, EvalEnv& env) {
+    if (SPECIAL_FORMS.contains(name)) return nullptr;
+    bool global = false;
+    auto value = findBinding(name, env, global);
+    if (!value || !global || typeid(*value) != typeid(LambdaValue)) return nullptr;
+    auto lambda = static_cast<const LambdaValue*>(value.get());
+    if (lambda->getBody().size() != 1 || lambda->getEnv()->getParent() || lambda->isTraced()) return nullptr;
+    return lambda;
+}
+
+// 预先检查有没有可折叠或内联之处，不分配内存；大多数过程体在这里就可以跳过
+bool mayFold(const ValuePtr& expr, EvalEnv& env) {
+    if (!expr->isPair()) return false;
+    if (auto name = expr->CAR()->asSymbol()) {
+        if (OPAQUE_FORMS.contains(*name)) return false;
+        if (inlineCandidate(*name, env)) return true;
+        if (*name == "if" && expr->CDR()->isPair() && isConstant(expr->CDR()->CAR())) return true;
+        if (*name == "cond") {
+            for (ValuePtr clause = expr->CDR(); clause->isPair(); clause = clause->CDR()) {
+                if (clause->CAR()->isPair() && isConstant(clause->CAR()->CAR())) return true;
+            }
+        }
+        if (PURE_BUILTINS.contains(*name)) {
+            bool constant = true;
+            for (ValuePtr arg = expr->CDR(); arg->isPair(); arg = arg->CDR()) {
+                constant = constant && isConstant(arg->CAR());
+            }
+            if (constant) return true;
+        }
+    }
+    for (ValuePtr current = expr; current->isPair(); current = current->CDR()) {
+        if (mayFold(current->CAR(), env)) return true;
+    }
+    return false;
+}
+
+// inspect 收集的过程体信息
+struct BodyInfo {
+    // 各参数出现的次数
+    std::vector<int> uses;
+    std::unordered_set<std::string> free;
+    // 过程体中按名字调用的过程；以表达式为过程调用时 indirect 为真
+    std::unordered_set<std::string> calls;
+    bool indirect = false;
+    // 含有 if、cond 等条件形式
+    bool conditional = false;
+    int size = 0;
+};
+
+class Folder {
+public:
+    Folder(EvalEnv& env, std::unordered_set<std::string> bound) : env(env), bound(std::move(bound)) {}
+
+    bool changed = false;
+    // 折叠或内联时认定指向全局绑定的名字，复用结果时它们不能在局部环境中另有绑定
+    std::unordered_set<std::string> resolved;
+    // 折叠中查看过绑定的名字，版本号在查看绑定之前读取
+    std::unordered_map<std::string, FoldDependency> watched;
+
+    FoldDependencies dependencies(const std::unordered_set<std::string>& names) const {
+        FoldDependencies result;
+        for (const auto& name : names) result.push_back(watched.at(name));
+        return result;
+    }
+
+    FoldDependencies allDependencies() const {
+        FoldDependencies result;
+        for (const auto& [name, dependency] : watched) result.push_back(dependency);
+        return result;
+    }
+
+    ValuePtr fold(const ValuePtr& expr) {
+        if (!expr->isPair()) return expr;
+        auto head = expr->CAR();
+        if (auto name = head->asSymbol()) {
+            if (OPAQUE_FORMS.contains(*name)) return expr;
+            // (define (f ...) ...) 会新建过程
+            if (*name == "define" && expr->CDR()->isPair() && expr->CDR()->CAR()->isPair()) return expr;
+            // 命名 let 的循环体会成为过程
+            if (*name == "let" && expr->CDR()->isPair() && expr->CDR()->CAR()->asSymbol()) return expr;
+        }
+        std::vector<ValuePtr> items;
+        ValuePtr current = expr;
+        for (; current->isPair(); current = current->CDR()) items.push_back(fold(current->CAR()));
+        bool same = true;
+        current = expr;
+        for (const auto& item : items) {
+            same = same && item == current->CAR();
+            current = current->CDR();
+        }
+        auto result = same ? expr : makeList(items.begin(), items.end(), current);
+        if (auto name = head->asSymbol()) {
+            if (*name == "if") return foldIf(result, items);
+            if (*name == "cond") return foldCond(result, items);
+            if (PURE_BUILTINS.contains(*name) && current->isNil()) return foldCall(result, *name, items);
+            if (current->isNil()) return inlineCall(result, *name, items);
+        }
+        return result;
+    }
+
+private:
+    EvalEnv& env;
+    std::unordered_set<std::string> bound;
+    // 正在展开的过程名，防止相互调用的过程无限展开
+    std::vector<std::string> inlining;
+
+    void watch(const std::string& name) {
+        if (watched.contains(name)) return;
+        auto version = versionOf(name);
+        watched.emplace(name, FoldDependency{version, version->load()});
+    }
+
+    // 名字在全局环境中绑定着同名的内置过程，且过程体内与外层局部环境都没有重新绑定它
+    bool isBuiltin(const std::string& name) {
+        if (bound.contains(name)) return false;
+        watch(name);
+        bool global = false;
+        auto proc = findBinding(name, env, global);
+        if (!proc || !global || typeid(*proc) != typeid(BuiltinProcValue) ||
+            static_cast<const BuiltinProcValue&>(*proc).getName() != name) {
+            return false;
+        }
+        resolved.insert(name);
+        return true;
+    }
+
+    // 没有副作用的实参：常量、变量，或以它们为参数的纯内置过程调用
+    bool isPure(const ValuePtr& expr) {
+        if (isConstant(expr) || expr->asSymbol()) return true;
+        if (!expr->isPair()) return false;
+        auto name = expr->CAR()->asSymbol();
+        if (!name || !PURE_BUILTINS.contains(*name) || !isBuiltin(*name)) return false;
+        ValuePtr arg = expr->CDR();
+        for (; arg->isPair(); arg = arg->CDR()) {
+            if (!isPure(arg->CAR())) return false;
+        }
+        return arg->isNil();
+    }
+
+    // 检查过程体能否内联，同时统计各参数出现的次数、收集自由变量与调用的过程
+    static bool inspect(const ValuePtr& expr, const std::string& self, const std::vector<std::string>& params,
+                        BodyInfo& info) {
+        if (++info.size > MAX_INLINE_SIZE) return false;
+        if (auto name = expr->asSymbol()) {
+            if (*name == self) return false;
+            auto it = std::find(params.begin(), params.end(), *name);
+            if (it != params.end()) info.uses[it - params.begin()]++;
+            else info.free.insert(*name);
+            return true;
+        }
+        if (!expr->isPair()) return true;
+        ValuePtr current = expr;
+        if (auto head = expr->CAR()->asSymbol()) {
+            if (*head == "quote") return true;
+            if (NON_INLINABLE_FORMS.contains(*head)) return false;
+            if (CONDITIONAL_FORMS.contains(*head)) info.conditional = true;
+            if (!SPECIAL_FORMS.contains(*head)) info.calls.insert(*head);
+            if (*head == "cond") {
+                // cond 的子句不是调用，只检查其中的表达式
+                for (current = expr->CDR(); current->isPair(); current = current->CDR()) {
+                    if (!current->CAR()->isPair()) return false;
+                    if (!isSymbol(current->CAR()->CAR(), "else") &&
+                        !inspect(current->CAR()->CAR(), self, params, info)) {
+                        return false;
+                    }
+                    ValuePtr rest = current->CAR()->CDR();
+                    for (; rest->isPair(); rest = rest->CDR()) {
+                        if (!inspect(rest->CAR(), self, params, info)) return false;
+                    }
+                    if (!rest->isNil()) return false;
+                }
+                return current->isNil();
+            }
+        } else {
+            info.indirect = true;
+        }
+        for (; current->isPair(); current = current->CDR()) {
+            if (!inspect(current->CAR(), self, params, info)) return false;
+        }
+        return current->isNil();
+    }
+
+    static ValuePtr substitute(const ValuePtr& expr, const std::vector<std::string>& params,
+                               const std::vector<ValuePtr>& args) {
+        if (auto name = expr->asSymbol()) {
+            auto it = std::find(params.begin(), params.end(), *name);
+            return it != params.end() ? args[it - params.begin()] : expr;
+        }
+        if (!expr->isPair() || isSymbol(expr->CAR(), "quote")) return expr;
+        return std::make_shared<PairValue>(substitute(expr->CAR(), params, args),
+                                           substitute(expr->CDR(), params, args));
+    }
+
+    // 内联：把小而非递归的全局过程的过程体代入调用处，参数替换为实参，省去新建环境。
+    // 过程体的自由变量须在调用处同样指向全局绑定。代入后实参推迟到过程体中求值，
+    // 因此只有过程体只调用纯内置过程时，实参才可以是变量（任意代入）或纯内置过程调用
+    // （对应参数须恰好无条件地出现一次）；否则过程体可能先修改实参读到的数据，只有常量实参可以代入
+    ValuePtr inlineCall(const ValuePtr& expr, const std::string& name, const std::vector<ValuePtr>& items) {
+        if (bound.contains(name) || inlining.size() >= MAX_INLINE_DEPTH ||
+            std::find(inlining.begin(), inlining.end(), name) != inlining.end()) {
+            return expr;
+        }
+        watch(name);
+        watch(TRACING);
+        auto callee = inlineCandidate(name, env);
+        if (!callee) return expr;
+        const auto& params = callee->getParams();
+        std::vector<ValuePtr> args(items.begin() + 1, items.end());
+        if (params.size() != args.size() || std::find(params.begin(), params.end(), ".") != params.end()) {
+            return expr;
+        }
+        const auto& body = callee->getBody()[0];
+        BodyInfo info;
+        info.uses.resize(params.size());
+        if (!inspect(body, name, params, info)) return expr;
+        for (const auto& symbol : info.free) {
+            // 之后在外层环境中定义同名变量会改变它的指向
+            watch(symbol);
+            bool global = true;
+            if (bound.contains(symbol) || (findBinding(symbol, env, global) && !global)) return expr;
+        }
+        bool pureBody = !info.indirect &&
+                        std::all_of(info.calls.begin(), info.calls.end(), [&](const std::string& call) {
+                            return PURE_BUILTINS.contains(call) && isBuiltin(call);
+                        });
+        for (std::size_t i = 0; i < args.size(); i++) {
+            if (isConstant(args[i])) continue;
+            if (!pureBody) return expr;
+            if (args[i]->asSymbol() && info.uses[i] > 0) continue;
+            if (info.uses[i] == 1 && !info.conditional && isPure(args[i])) continue;
+            return expr;
+        }
+        resolved.insert(name);
+        resolved.insert(TRACING);
+        resolved.insert(info.free.begin(), info.free.end());
+        changed = true;
+        inlining.push_back(name);
+        auto result = fold(substitute(body, params, args));
+        inlining.pop_back();
+        return result;
+    }
+
+    static ValuePtr constantValue(const ValuePtr& expr) {
+        return expr->isSelfEvaluating() ? expr : expr->CDR()->CAR();
+    }
+
+    // 把值写回表达式：能自求值的原样放入，其余加上 quote
+    ValuePtr literal(const ValuePtr& value) {
+        changed = true;
+        if (value->isSelfEvaluating()) return value;
+        return std::make_shared<PairValue>(std::make_shared<SymbolValue>("quote"),
+                                           std::make_shared<PairValue>(value, std::make_shared<NilValue>()));
+    }
+
+    ValuePtr replaced(const ValuePtr& expr) {
+        changed = true;
+        return expr;
+    }
+
+    ValuePtr foldCall(const ValuePtr& expr, const std::string& name, const std::vector<ValuePtr>& items) {
+        std::vector<ValuePtr> args;
+        for (auto it = items.begin() + 1; it != items.end(); ++it) {
+            if (!isConstant(*it)) return expr;
+            args.push_back(constantValue(*it));
+        }
+        if (!isBuiltin(name)) return expr;
+        try {
+            const auto& builtin = static_cast<const BuiltinProcValue&>(*env.lookupBinding(name));
+            return literal(builtin.getFunc()(args));
+        } catch (std::exception&) {
+            // 出错（如除以零）的调用留到运行时再报告
+            return expr;
+        }
+    }
+
+    ValuePtr foldIf(const ValuePtr& expr, const std::vector<ValuePtr>& items) {
+        if ((items.size() != 3 && items.size() != 4) || !isConstant(items[1])) return expr;
+        if (constantValue(items[1])->asBool()) return replaced(items[2]);
+        if (items.size() == 4) return replaced(items[3]);
+        return literal(std::make_shared<NilValue>());
+    }
+
+    // 与 condForm 保持一致：子句只求值第一个表达式，至少两个子句，全不满足时报错。
+    // 去掉条件恒假的子句，条件恒真的子句之后的子句不会执行；若它成了第一个子句，整个 cond 即其结果
+    ValuePtr foldCond(const ValuePtr& expr, const std::vector<ValuePtr>& items) {
+        if (items.size() < 3) return expr;
+        std::vector<ValuePtr> clauses{items[0]};
+        bool pruned = false;
+        for (auto it = items.begin() + 1; it != items.end(); ++it) {
+            const auto& clause = *it;
+            if (clause->isPair() && isSymbol(clause->CAR(), "else")) {
+                // else 之后若还有子句，运行时报错，原样保留
+                clauses.insert(clauses.end(), it, items.end());
+                break;
+            }
+            if (!clause->isPair() || !clause->CDR()->isPair() || !isConstant(clause->CAR())) {
+                clauses.push_back(clause);
+                continue;
+            }
+            if (!constantValue(clause->CAR())->asBool()) {
+                pruned = true;
+                continue;
+            }
+            if (clauses.size() == 1) return replaced(clause->CDR()->CAR());
+            clauses.push_back(clause);
+            pruned = pruned || it + 1 != items.end();
+            break;
+        }
+        if (!pruned || clauses.size() < 3) return expr;
+        changed = true;
+        return makeList(clauses.begin(), clauses.end());
+    }
+};
+
+// 折叠结果按 lambda 源表达式缓存：循环中反复创建同一个 lambda 时只折叠一次。
+// 折叠中查看过的名字都没有被修改、且 resolved 中的名字在新的定义环境里仍指向全局绑定时有效
+struct FoldCacheEntry {
+    // 持有源表达式，保证作为键的地址不会被别的表达式复用
+    std::vector<ValuePtr> source;
+    std::vector<std::string> params;
+    FoldDependencies watched;
+    std::unordered_set<std::string> resolved;
+    std::optional<FoldedBody> result;
+};
+
+constexpr std::size_t MAX_FOLD_CACHE = 4096;
+thread_local std::unordered_map<const Value*, FoldCacheEntry> foldCache;
+
+FoldCacheEntry fold(const std::vector<std::string>& params, const std::vector<ValuePtr>& body, EvalEnv& env) {
+    FoldCacheEntry entry{body, params, {}, {}, std::nullopt};
+    if (std::none_of(body.begin(), body.end(), [&](const ValuePtr& expr) { return mayFold(expr, env); })) {
+        return entry;
+    }
+    std::unordered_set<std::string> bound(params.begin(), params.end());
+    for (const auto& expr : body) collectBound(expr, bound);
+    Folder folder(env, std::move(bound));
+    std::vector<ValuePtr> result;
+    result.reserve(body.size());
+    for (const auto& expr : body) result.push_back(folder.fold(expr));
+    entry.watched = folder.allDependencies();
+    if (folder.changed) {
+        // 过程体只依赖认定指向全局绑定的名字；其余名字的修改只可能带来新的化简机会
+        entry.result = FoldedBody{std::move(result), folder.dependencies(folder.resolved)};
+        entry.resolved = std::move(folder.resolved);
+    }
+    return entry;
+}
+
+}  // namespace
+
+void invalidateFolding(const std::string& name) {
+    bump(name);
+}
+
+void invalidateInlining() {
+    bump(TRACING);
+}
+
+bool stillValid(const FoldDependencies& dependencies) {
+    return std::all_of(dependencies.begin(), dependencies.end(), [](const FoldDependency& dependency) {
+        return dependency.version->load() == dependency.seen;
+    });
+}
+
+std::optional<FoldedBody> foldBody(const std::vector<std::string>& params, const std::vector<ValuePtr>& body,
+                                   EvalEnv& env) {
+    if (body.empty()) return std::nullopt;
+    auto it = foldCache.find(body[0].get());
+    if (it != foldCache.end()) {
+        const auto& entry = it->second;
+        if (entry.source == body && entry.params == params && stillValid(entry.watched) &&
+            std::none_of(entry.resolved.begin(), entry.resolved.end(),
+                         [&](const std::string& name) { return boundLocally(name, env); })) {
+            return entry.result;
+        }
+    }
+    auto entry = fold(params, body, env);
+    auto result = entry.result;
+    if (foldCache.size() >= MAX_FOLD_CACHE) foldCache.clear();
+    foldCache[body[0].get()] = std::move(entry);
+    return result;
+}
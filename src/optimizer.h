@@ -0,0 +1,44 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "./eval_env.h"
+
+// 常量折叠：lambda 创建闭包时化简一遍过程体。参数都是常量的纯内置过程调用（算术、比较、
+// 对引用数据取 car/cdr 等）直接替换为结果，条件为常量的 if/cond 只保留会执行的分支。
+// 只有调用处的名字在定义环境中确实绑定着同名内置过程、且过程体内没有重新绑定它时才折叠。
+// 折叠依赖的每个名字有一个版本号，之后任何环境中 define 或 set! 了这个名字，版本号递增，
+// 只有依赖它的过程体失效。同一个 lambda 表达式再次创建闭包时复用缓存的折叠结果。
+
+// 依赖的名字的版本号，以及折叠时看到的值
+struct FoldDependency {
+    const std::atomic<std::uint64_t>* version;
+    std::uint64_t seen;
+};
+using FoldDependencies = std::vector<FoldDependency>;
+
+struct FoldedBody {
+    std::vector<ValuePtr> body;
+    FoldDependencies dependencies;
+};
+
+// 任何被依赖的名字改变时递增。与上次核对时相同就不必逐个核对版本号
+extern std::atomic<std::uint64_t> foldEpoch;
+
+// define / set! 修改绑定后调用
+void invalidateFolding(const std::string& name);
+// 开关过程跟踪时调用，内联过过程的过程体须重新核对
+void invalidateInlining();
+// 依赖的名字都没有被修改过
+bool stillValid(const FoldDependencies& dependencies);
+
+// 返回折叠后的过程体；没有可化简之处时返回空。结果按线程缓存
+std::optional<FoldedBody> foldBody(const std::vector<std::string>& params, const std::vector<ValuePtr>& body,
+                                   EvalEnv& env);
+
+#endif
@@ -0,0 +1,132 @@
+#include "./parallel.h"
+
+#include <exception>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 当前线程所属的线程池及其在池中的下标，非工作线程为空
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local std::size_t currentIndex = 0;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t threads) {
+    if (threads == 0) threads = 1;
+    for (std::size_t i = 0; i < threads; i++) queues.push_back(std::make_unique<Queue>());
+    for (std::size_t i = 0; i < threads; i++) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // 工作线程提交到自己的队列，其他线程轮流分散到各个队列
+    auto index = currentPool == this ? currentIndex : nextQueue++ % queues.size();
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(sleepMutex);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::popLocal(std::size_t index, std::function<void()>& task) {
+    auto& queue = *queues[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t start, std::function<void()>& task) {
+    for (std::size_t i = 0; i < queues.size(); i++) {
+        auto& queue = *queues[(start + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool WorkStealingPool::runPending() {
+    std::function<void()> task;
+    bool found = currentPool == this ? popLocal(currentIndex, task) || steal(currentIndex + 1, task)
+                                     : steal(nextQueue++ % queues.size(), task);
+    if (!found) return false;
+    pending--;
+    task();
+    return true;
+}
+
+void WorkStealingPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        if (runPending()) continue;
+        std::unique_lock lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending > 0; });
+        if (stopping) return;
+    }
+}
+
+WorkStealingPool& defaultPool() {
+    static std::mutex mutex;
+    static WorkStealingPool* pool = nullptr;
+#ifndef _WIN32
+    static pid_t owner = 0;
+#endif
+    std::lock_guard lock(mutex);
+#ifndef _WIN32
+    // 父进程的线程不会随 fork 复制，旧池无法再析构，只能弃置
+    if (pool && owner != ::getpid()) pool = nullptr;
+    owner = ::getpid();
+#endif
+    // 有意不释放：退出时仍可能有任务在运行
+    if (!pool) pool = new WorkStealingPool(std::thread::hardware_concurrency());
+    return *pool;
+}
+
+void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body) {
+    if (count == 0) return;
+    struct State {
+        std::atomic<std::size_t> remaining;
+        std::mutex mutex;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = count;
+    auto& pool = defaultPool();
+    for (std::size_t i = 0; i < count; i++) {
+        pool.submit([state, &body, i] {
+            try {
+                body(i);
+            } catch (...) {
+                std::lock_guard lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            state->remaining--;
+        });
+    }
+    while (state->remaining > 0) {
+        if (!pool.runPending()) std::this_thread::yield();
+    }
+    if (state->error) std::rethrow_exception(state->error);
+}
@@ -0,0 +1,56 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池：每个工作线程有自己的任务队列，从队尾取自己提交的任务，
+// 自己的队列空了就从其他队列的队首窃取。等待任务完成的线程也会帮忙执行任务，
+// 因此在任务中再次提交并等待子任务不会死锁。
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(std::size_t threads);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // 取出并执行一个任务，没有可执行的任务时返回假
+    bool runPending();
+    std::size_t size() const { return workers.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<long> pending{0};  // 可能因先取后计数而短暂为负
+    std::atomic<std::size_t> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void workerLoop(std::size_t index);
+    bool popLocal(std::size_t index, std::function<void()>& task);
+    bool steal(std::size_t start, std::function<void()>& task);
+};
+
+// 进程内共享的线程池，线程数等于硬件并发数。fork 出的子进程中没有父进程的工作线程，
+// 首次使用时会重新建池。
+WorkStealingPool& defaultPool();
+
+// 在线程池上执行 body(0) ... body(count - 1)，全部完成后返回；当前线程等待期间也参与执行。
+// 任务抛出的第一个异常在全部任务结束后重新抛出。
+void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+#endif
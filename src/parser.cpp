@@ -1,5 +1,6 @@
 #include "./parser.h"
 #include "./error.h"
+#include "./vector_value.h"
 Parser::Parser(std::deque<TokenPtr> token) : tokens(std::move(token)) {}
 
 
@@ -35,6 +36,10 @@ ValuePtr Parser::parse(){
         return this->parseTails();
     }
 
+    if (token->getType() == TokenType::VECTOR_BEGIN){
+        return this->parseVector();
+    }
+
     if (token->getType() == TokenType::QUOTE) {
         return handleQuote(TokenType::QUOTE);
     }
@@ -51,35 +56,53 @@ ValuePtr Parser::parse(){
 }
 
 ValuePtr Parser::parseTails(){
+    // 依次解析各元素，遇到右括号或点时用列表构造器一次性连成列表
+    std::vector<ValuePtr> elements;
+    while (true) {
+        if (tokens.empty()) {
+            throw SyntaxError("Unexpected end of input");
+        }
 
-    // 如果是右括号，则返回空表
-    if (tokens.front()->getType() == TokenType::RIGHT_PAREN){
-        tokens.pop_front();
-        return std::make_shared<NilValue>();
-    }
-    
-    // 如果不是右括号，则递归解析
-    auto car = this->parse();
+        // 如果是右括号，则以空表结尾
+        if (tokens.front()->getType() == TokenType::RIGHT_PAREN){
+            tokens.pop_front();
+            return makeList(elements.begin(), elements.end());
+        }
 
-    if (tokens.empty()) {
-        throw SyntaxError("Unexpected end of input");
+        // 如果是点，则点后的值作为最后一个对子的 cdr
+        if (tokens.front()->getType() == TokenType::DOT){
+            if (elements.empty()) {
+                throw SyntaxError("Unexpected token '.'");
+            }
+            tokens.pop_front();
+            auto cdr = this->parse();
+            // 检测下一个token是否是右括号，如果不是则报错
+            if (tokens.empty() || tokens.front()->getType() != TokenType::RIGHT_PAREN){
+                throw SyntaxError("Unexpected token, expected for ')'");
+            }
+            tokens.pop_front();
+            return makeList(elements.begin(), elements.end(), cdr);
+        }
+
+        elements.push_back(this->parse());
     }
+}
 
-    // 如果接下来是点，则返回一个对子
-    if (tokens.front()->getType() == TokenType::DOT){
-        tokens.pop_front();
-        auto cdr = this->parse();
-        // 检测下一个token是否是右括号，如果不是则报错
-        if (tokens.front()->getType() != TokenType::RIGHT_PAREN){
-            throw SyntaxError("Unexpected token, expected for ')'");
+// 解析 #( ... ) 向量字面量，元素不求值
+ValuePtr Parser::parseVector(){
+    std::vector<ValuePtr> elements;
+    while (true) {
+        if (tokens.empty()) {
+            throw SyntaxError("Unexpected end of input");
+        }
+        if (tokens.front()->getType() == TokenType::RIGHT_PAREN){
+            tokens.pop_front();
+            return std::make_shared<VectorValue>(std::move(elements));
+        }
+        if (tokens.front()->getType() == TokenType::DOT){
+            throw SyntaxError("Unexpected token '.' in vector");
         }
-        tokens.pop_front();
-        return std::make_shared<PairValue>(car, cdr);
-    } 
-    // 如果接下来不是点，则递归解析
-    else {
-        auto cdr = this->parseTails();
-        return std::make_shared<PairValue>(car, cdr);
+        elements.push_back(this->parse());
     }
 }
 
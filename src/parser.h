@@ -13,10 +13,12 @@ class Parser {
 public:
     Parser(std::deque<TokenPtr> token);
     ValuePtr parse();
+    bool isEnd() const { return tokens.empty(); }
     
 private:
     std::deque<TokenPtr> tokens;
     ValuePtr parseTails();
+    ValuePtr parseVector();
     ValuePtr handleQuote(TokenType quoteType);
 
 };
@@ -0,0 +1,115 @@
+#include "./profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+
+bool profiling = false;
+
+namespace {
+
+constexpr int SAMPLE_INTERVAL_MS = 10;
+
+std::atomic<bool> sampleDue{false};
+thread_local std::vector<const std::string*> callStack;
+
+std::mutex samplesMutex;
+std::size_t totalSamples = 0;
+std::unordered_map<std::string, std::size_t> selfSamples;
+std::unordered_map<std::string, std::size_t> totalByName;
+std::map<std::string, std::size_t> foldedSamples;
+std::string foldedOutput;
+
+void record() {
+    if (callStack.empty()) return;
+    std::string folded;
+    std::set<std::string_view> seen;
+    std::lock_guard lock(samplesMutex);
+    totalSamples++;
+    selfSamples[*callStack.back()]++;
+    for (auto name : callStack) {
+        // 递归调用在同一个样本中只计一次累计时间
+        if (seen.insert(*name).second) totalByName[*name]++;
+        if (!folded.empty()) folded += ';';
+        folded += *name;
+    }
+    foldedSamples[folded]++;
+}
+
+void poll() {
+#ifdef _WIN32
+    // 没有 SIGPROF 时按调用次数采样
+    static thread_local unsigned counter = 0;
+    if (++counter % 1000 == 0) record();
+#else
+    if (sampleDue.load(std::memory_order_relaxed) && sampleDue.exchange(false)) record();
+#endif
+}
+
+void report() {
+    std::lock_guard lock(samplesMutex);
+    std::vector<std::pair<std::string, std::size_t>> rows(selfSamples.begin(), selfSamples.end());
+    for (const auto& [name, count] : totalByName) {
+        if (!selfSamples.contains(name)) rows.emplace_back(name, 0);
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return totalByName[a.first] > totalByName[b.first];
+    });
+    auto percent = [](std::size_t count) { return totalSamples ? 100.0 * count / totalSamples : 0.0; };
+    std::cerr << std::endl << "Profile: " << totalSamples << " samples" << std::endl;
+    std::cerr << "   self%   total%  procedure" << std::endl;
+    for (const auto& [name, self] : rows) {
+        std::cerr << std::fixed << std::setprecision(1) << std::setw(8) << percent(self) << std::setw(9)
+                  << percent(totalByName[name]) << "  " << name << std::endl;
+    }
+    if (!foldedOutput.empty()) {
+        std::ofstream out(foldedOutput, std::ios::trunc);
+        for (const auto& [stack, count] : foldedSamples) out << stack << ' ' << count << '\n';
+        if (!out) std::cerr << "Cannot write folded stacks to " << foldedOutput << std::endl;
+    }
+}
+
+}  // namespace
+
+void startProfiler(const std::string& foldedPath) {
+    profiling = true;
+    foldedOutput = foldedPath;
+    std::atexit(report);
+#ifndef _WIN32
+    struct sigaction action {};
+    action.sa_handler = [](int) { sampleDue.store(true, std::memory_order_relaxed); };
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+    itimerval timer{};
+    timer.it_interval.tv_usec = SAMPLE_INTERVAL_MS * 1000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+#endif
+}
+
+ProfileFrame::ProfileFrame(const std::string& name) {
+    // 进入前到期的时间花在调用者求值实参等工作上，记在调用者名下
+    poll();
+    callStack.push_back(&name);
+}
+
+ProfileFrame::~ProfileFrame() {
+    // 离开前再看一次，耗时的内置过程（如 sort）因此能记到自己名下
+    poll();
+    callStack.pop_back();
+}
@@ -0,0 +1,26 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <vector>
+
+// 采样分析器（--profile）：计时器每 10 ms（进程 CPU 时间）置一次标志，
+// EvalEnv::apply 在进入和离开过程时查看标志，到期则记录当前线程的 Lisp 调用栈。
+// 退出时打印按自身与累计采样数排序的报告，并可输出火焰图工具使用的折叠栈格式。
+
+// 是否开启采样；关闭时 apply 只多一次判断
+extern bool profiling;
+
+// 开启采样，foldedPath 非空时在退出时写入折叠栈
+void startProfiler(const std::string& foldedPath);
+
+// 在当前线程的调用栈上记录一层过程调用，析构时弹出
+class ProfileFrame {
+public:
+    explicit ProfileFrame(const std::string& name);
+    ~ProfileFrame();
+    ProfileFrame(const ProfileFrame&) = delete;
+    ProfileFrame& operator=(const ProfileFrame&) = delete;
+};
+
+#endif
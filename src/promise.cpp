@@ -0,0 +1,158 @@
+#include "./promise.h"
+#include "./error.h"
+
+#include <vector>
+
+PromiseValue::PromiseValue(ValuePtr expr, std::shared_ptr<EvalEnv> env)
+    : Value(STAT_VALUE_PROMISE), expr(std::move(expr)), env(std::move(env)) {}
+
+PromiseValue::PromiseValue(std::function<ValuePtr()> thunk) : Value(STAT_VALUE_PROMISE), thunk(std::move(thunk)) {}
+
+std::shared_ptr<PromiseValue> PromiseValue::ready(ValuePtr value) {
+    auto promise = std::make_shared<PromiseValue>(nullptr, nullptr);
+    promise->value = std::move(value);
+    promise->done = true;
+    return promise;
+}
+
+PromiseValue::~PromiseValue() {
+    releaseChain(std::move(value));
+}
+
+ValuePtr PromiseValue::force() {
+    ValuePtr pendingExpr;
+    std::shared_ptr<EvalEnv> pendingEnv;
+    std::function<ValuePtr()> pendingThunk;
+    {
+        ValueReadLock lock(*this);
+        if (done) return value;
+        pendingExpr = expr;
+        pendingEnv = env;
+        pendingThunk = thunk;
+    }
+    // 求值时不持有锁：求值过程中可能递归地 force 自己，其他任务也可能同时 force，以先得到的结果为准
+    auto result = pendingThunk ? pendingThunk() : pendingEnv->eval(pendingExpr);
+    ValueWriteLock lock(*this);
+    if (!done) {
+        value = std::move(result);
+        done = true;
+        expr = nullptr;
+        env = nullptr;
+        thunk = nullptr;
+    }
+    return value;
+}
+
+ValuePtr force(const ValuePtr& value) {
+    if (auto promise = dynamic_cast<PromiseValue*>(value.get())) return promise->force();
+    return value;
+}
+
+ValuePtr forceProc(const std::vector<ValuePtr>& params) {
+    if (params.size() != 1) {
+        throw LispError("force expects exactly one argument.");
+    }
+    return force(params[0]);
+}
+
+ValuePtr makePromise(const std::vector<ValuePtr>& params) {
+    if (params.size() != 1) {
+        throw LispError("make-promise expects exactly one argument.");
+    }
+    if (dynamic_cast<const PromiseValue*>(params[0].get())) return params[0];
+    return PromiseValue::ready(params[0]);
+}
+
+ValuePtr isPromise(const std::vector<ValuePtr>& params) {
+    if (params.size() != 1) {
+        throw LispError("promise? expects exactly one argument.");
+    }
+    return std::make_shared<BooleanValue>(dynamic_cast<const PromiseValue*>(params[0].get()) != nullptr);
+}
+
+namespace {
+
+const PairValue& asStream(const ValuePtr& value, const std::string& procName) {
+    if (!value->isPair()) throw LispError(procName + " expects a non-empty stream.");
+    return static_cast<const PairValue&>(*value);
+}
+
+// 流的后继：cdr 是承诺时求值，否则原样返回
+ValuePtr rest(const PairValue& stream) {
+    return force(stream.getCdr());
+}
+
+ValuePtr mapStream(ValuePtr proc, ValuePtr stream, std::shared_ptr<EvalEnv> env) {
+    if (!stream->isPair()) return stream;
+    const auto& pair = static_cast<const PairValue&>(*stream);
+    auto head = env->apply(proc, {pair.getCar()});
+    auto tail = std::make_shared<PromiseValue>([proc, stream, env] {
+        return mapStream(proc, rest(static_cast<const PairValue&>(*stream)), env);
+    });
+    return std::make_shared<PairValue>(std::move(head), std::move(tail));
+}
+
+ValuePtr filterStream(ValuePtr pred, ValuePtr stream, std::shared_ptr<EvalEnv> env) {
+    // 跳过不满足条件的元素时原地循环，不留下已走过的部分
+    std::vector<ValuePtr> arg(1);
+    while (stream->isPair()) {
+        const auto& pair = static_cast<const PairValue&>(*stream);
+        arg[0] = pair.getCar();
+        if (env->apply(pred, arg)->asBool()) {
+            auto tail = std::make_shared<PromiseValue>([pred, stream, env] {
+                return filterStream(pred, rest(static_cast<const PairValue&>(*stream)), env);
+            });
+            return std::make_shared<PairValue>(pair.getCar(), std::move(tail));
+        }
+        stream = rest(pair);
+    }
+    return stream;
+}
+
+}  // namespace
+
+ValuePtr streamCar(const std::vector<ValuePtr>& params) {
+    if (params.size() != 1) {
+        throw LispError("stream-car expects exactly one argument.");
+    }
+    return asStream(params[0], "stream-car").getCar();
+}
+
+ValuePtr streamCdr(const std::vector<ValuePtr>& params) {
+    if (params.size() != 1) {
+        throw LispError("stream-cdr expects exactly one argument.");
+    }
+    return rest(asStream(params[0], "stream-cdr"));
+}
+
+ValuePtr streamTake(const std::vector<ValuePtr>& params) {
+    if (params.size() != 2) {
+        throw LispError("stream-take expects exactly two arguments.");
+    }
+    if (!params[1]->isNumber() || params[1]->asNumber() < 0) {
+        throw LispError("stream-take expects a non-negative count.");
+    }
+    auto count = static_cast<std::size_t>(params[1]->asNumber());
+    std::vector<ValuePtr> elements;
+    ValuePtr stream = params[0];
+    while (elements.size() < count && stream->isPair()) {
+        const auto& pair = static_cast<const PairValue&>(*stream);
+        elements.push_back(pair.getCar());
+        if (elements.size() < count) stream = rest(pair);
+    }
+    return makeList(elements.begin(), elements.end());
+}
+
+ValuePtr streamMap(const std::vector<ValuePtr>& params, EvalEnv& env) {
+    if (params.size() != 2 || !params[0]->isProcedure()) {
+        throw LispError("stream-map expects a procedure and a stream.");
+    }
+    return mapStream(params[0], params[1], env.shared_from_this());
+}
+
+ValuePtr streamFilter(const std::vector<ValuePtr>& params, EvalEnv& env) {
+    if (params.size() != 2 || !params[0]->isProcedure()) {
+        throw LispError("stream-filter expects a procedure and a stream.");
+    }
+    return filterStream(params[0], params[1], env.shared_from_this());
+}
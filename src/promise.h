@@ -0,0 +1,49 @@
+#ifndef PROMISE_H
+#define PROMISE_H
+
+#include <functional>
+#include <memory>
+
+#include "./eval_env.h"
+#include "./value.h"
+
+// 承诺：第一次 force 时求值并记住结果，之后直接返回。
+// 由 delay 创建时保存表达式与环境，由内置的流过程创建时保存一个本地函数；
+// 求值后两者都会释放，已经走过的流不会因此一直被引用。
+class PromiseValue : public Value {
+public:
+    PromiseValue(ValuePtr expr, std::shared_ptr<EvalEnv> env);
+    explicit PromiseValue(std::function<ValuePtr()> thunk);
+    // 已求值的承诺
+    static std::shared_ptr<PromiseValue> ready(ValuePtr value);
+    ~PromiseValue();
+
+    std::string toString() const override { return "#<promise>"; }
+    bool isTransferable() const override { return false; }
+    ValuePtr takeTail() override { return std::move(value); }
+
+    ValuePtr force();
+
+private:
+    ValuePtr expr;
+    std::shared_ptr<EvalEnv> env;
+    std::function<ValuePtr()> thunk;
+    ValuePtr value;
+    bool done = false;
+};
+
+// 非承诺的值原样返回
+ValuePtr force(const ValuePtr& value);
+
+ValuePtr forceProc(const std::vector<ValuePtr>& params);
+ValuePtr makePromise(const std::vector<ValuePtr>& params);
+ValuePtr isPromise(const std::vector<ValuePtr>& params);
+ValuePtr streamCar(const std::vector<ValuePtr>& params);
+ValuePtr streamCdr(const std::vector<ValuePtr>& params);
+ValuePtr streamTake(const std::vector<ValuePtr>& params);
+
+// 需要调用过程参数的流过程
+ValuePtr streamMap(const std::vector<ValuePtr>& params, EvalEnv& env);
+ValuePtr streamFilter(const std::vector<ValuePtr>& params, EvalEnv& env);
+
+#endif
@@ -13,6 +13,8 @@ public:
     std::string toString() const override;
     bool isNumber() const override { return true; }
     bool isRational() const override { return true; }
+    int getNumerator() const { return numerator; }
+    int getDenominator() const { return denominator; }
     friend RationalValue addRational(const RationalValue& lhs, const RationalValue& rhs);
     friend RationalValue minusRational(const RationalValue& lhs, const RationalValue& rhs);
     friend RationalValue timesRational(const RationalValue& lhs, const RationalValue& rhs);
@@ -4,80 +4,98 @@
 
 #include "./error.h"
 #include "./eval_env.h"
+#include "./eval_limits.h"
+#include "./fasl.h"
 #include "./parser.h"
 
 #include "./tokenizer.h"
 #include "./value.h"
 #include "./rational.h"
 
-#include <stack>
+#include <cctype>
+#include <iterator>
+#include <sstream>
 #include <string>
 
-ValuePtr evaluate(std::string input, EvalEnv& env){
+// 解析一段完整输入中的全部表达式
+std::vector<ValuePtr> parseForms(const std::string& input){
     auto tokens = Tokenizer::tokenize(input);
     Parser parser(std::move(tokens));
-    auto value = parser.parse();
-    return env.eval(std::move(value));
+    std::vector<ValuePtr> forms;
+    while(!parser.isEnd()){
+        forms.push_back(parser.parse());
+    }
+    return forms;
 }
 
-bool is_parentheses_balanced(const std::string& input){
-    std::stack<char> stack;
-    for(char c : input){
+bool LineReader::feed(const std::string& line){
+    for(std::size_t i = 0; i < line.size(); i++){
+        char c = line[i];
+        if(inBlockComment){
+            if(c == '|' && i + 1 < line.size() && line[i + 1] == '#'){
+                inBlockComment = false;
+                i++;
+            }
+            continue;
+        }
+        if(inString){
+            buffer += c;
+            if(escaped) escaped = false;
+            else if(c == '\\') escaped = true;
+            else if(c == '"') inString = false;
+            continue;
+        }
         switch (c)
         {
+        case ';':
+            i = line.size();
+            continue;
+        case '#':
+            if(i + 1 < line.size() && line[i + 1] == '|'){
+                inBlockComment = true;
+                i++;
+                continue;
+            }
+            break;
+        case '"':
+            inString = true;
+            break;
         case '(':
-            stack.push(c);
+            depth++;
             break;
         case ')':
-            if(stack.empty()){
+            if(depth == 0){
+                reset();
                 throw FileError("Parentheses are not balanced");
-                std::exit(0);
             }
-            stack.pop();
+            depth--;
             break;
         default:
             break;
         }
+        buffer += c;
+        if(!std::isspace(static_cast<unsigned char>(c))) hasContent = true;
     }
-    return stack.empty();
+    // 字符串内保留换行，其余位置用空格分隔相邻两行
+    buffer += inString ? '\n' : ' ';
+    return hasContent && depth == 0 && !inString && !inBlockComment;
 }
 
-bool is_blockComment_balanced(const std::string& input){
-    auto pos = input.find("#|");
-    if (pos == std::string::npos) return true;
-        auto endPos = input.find("|#", pos);
-    if (endPos == std::string::npos) {
-        return false;
-    } else {
-        return true;
-    }       
+std::string LineReader::take(){
+    std::string result = std::move(buffer);
+    reset();
+    return result;
 }
 
-void deleteLineComment(std::string& input){
-    auto pos = input.find(";");
-    if (pos == std::string::npos) return;
-    input.erase(pos);
+void LineReader::reset(){
+    buffer.clear();
+    depth = 0;
+    inString = false;
+    escaped = false;
+    inBlockComment = false;
+    hasContent = false;
 }
 
-void deleteBlockComment(std::string& input){
-    auto pos = input.find("#|");
-    if (pos == std::string::npos) return;
-    auto endPos = input.find("|#", pos);
-    if (endPos == std::string::npos) {
-        throw FileError("Block comment is not closed");
-        std::exit(0);
-    }
-    input.erase(pos, endPos - pos + 2);
-}
-
-void deletenewline(std::string& input){
-    while(input.find("\n") != std::string::npos){
-        auto pos = input.find("\n");
-        input.erase(pos, 1);
-    }
-}
-
-
 void printIndented(const std::string& line, int indentLevel){    
     std::cout << line;
     for(int i = 0; i < indentLevel; ++i){
@@ -86,78 +104,88 @@ void printIndented(const std::string& line, int indentLevel){
 }
 
 void REPLmode(){
-    std::shared_ptr<EvalEnv> env{new EvalEnv};
-    std::string input="";
-    int indentLevel = 0;
+    REPLmode(std::shared_ptr<EvalEnv>{new EvalEnv});
+}
+
+void REPLmode(std::shared_ptr<EvalEnv> env){
+    LineReader reader;
     while(true){
         try {
-            if(is_parentheses_balanced(input))  printIndented(">>> ", indentLevel);
-            else printIndented("... ", indentLevel);
+            //  缩进规则：按尚未闭合的括号层数缩进
+            printIndented(reader.isOpen() ? "... " : ">>> ", reader.getDepth());
             std::string line;
             std::getline(std::cin, line);
             if (std::cin.eof()) {
                 std::exit(0);
             }
-            deleteLineComment(line);
-            deletenewline(line);
-            if(line.empty()) continue;
-            //  缩进规则
-            int newIndent = std::count(line.begin(), line.end(), '(') - std::count(line.begin(), line.end(), ')');
-            indentLevel += newIndent;
-
-            input += line;
-            if(!is_blockComment_balanced(input)) continue;
-            deleteBlockComment(input);
-            if(!is_parentheses_balanced(input)) {
-                input += " ";
-                continue;
+            if(!reader.feed(line)) continue;
+            for(const auto& form : parseForms(reader.take())){
+                resetStepBudget();
+                std::cout << env->eval(form)->toString() << std::endl;
             }
-            if(input.empty()) continue;
-            auto result = evaluate(input, *env);
-            std::cout << result->toString() << std::endl;
-            input.clear();
-            indentLevel = 0;
         } catch (std::runtime_error& e) {
             std::cerr << "Error: " << e.what() << std::endl;
-            input.clear();
-            indentLevel = 0;
+            reader.reset();
         }        
     }
 }
 
-void filemode(const std::string& filename) {
-    std::shared_ptr<EvalEnv> env{new EvalEnv};
-    std::ifstream file(filename);
+// 按行读取源代码，切分出完整的表达式并解析
+std::vector<ValuePtr> readForms(std::istream& in, bool& complete) {
+    std::vector<ValuePtr> forms;
+    LineReader reader;
+    std::string line;
+    complete = true;
+
+    while(std::getline(in, line)){
+        try {
+            if(!reader.feed(line)) continue;
+            for(auto& form : parseForms(reader.take())){
+                forms.push_back(std::move(form));
+            }
+        } catch (std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            complete = false;
+            reader.reset();
+        }
+    }
+    return forms;
+}
+
+void loadFile(const std::string& filename, EvalEnv& env) {
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         throw FileError("File not found");
-        std::exit(0);
     }
+    std::string source{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    file.close();
 
-    std::string input;
-    std::string line;
+    // 优先使用与源文件内容匹配的 FASL 缓存，跳过词法与语法分析
+    auto key = makeFaslKey(filename, source);
+    auto cachePath = faslPath(filename);
+    std::vector<ValuePtr> forms;
+    if (auto cached = readFasl(cachePath, key)) {
+        forms = std::move(*cached);
+    } else {
+        std::istringstream in(source);
+        bool complete;
+        forms = readForms(in, complete);
+        // 含语法错误的文件不缓存，保证下次加载仍能报告错误
+        if (complete) writeFasl(cachePath, key, forms);
+    }
 
-    while(std::getline(file, line)){
+    for (const auto& form : forms) {
         try {
-            deleteLineComment(line);
-            if(line.empty()) continue;
-            input += line;
-            if(!is_blockComment_balanced(input)) continue;
-            deleteBlockComment(input);
-            if(!is_parentheses_balanced(input)) {
-                input += " ";
-                continue;
-            }
-            if(!input.empty()){
-                auto result = evaluate(input, *env);
-                input.clear();
-            }
+            env.eval(form);
         } catch (std::runtime_error& e) {
             std::cerr << "Error: " << e.what() << std::endl;
-            input.clear();
         }
     }
+}
 
-    file.close();
+void filemode(const std::string& filename) {
+    std::shared_ptr<EvalEnv> env{new EvalEnv};
+    loadFile(filename, *env);
 }
 
 std::string readInput(){
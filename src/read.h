@@ -1,13 +1,45 @@
 #ifndef READ_H
 #define READ_H
 
+#include <istream>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "./value.h"
+
+class EvalEnv;
+
+// 逐行累积输入的读取器。括号层数、是否处于字符串或块注释中等词法状态跨行保存，
+// 每行输入只扫描一遍；注释在扫描时直接丢弃。
+class LineReader {
+public:
+    // 读入一行，返回 true 表示已累积出完整的表达式
+    bool feed(const std::string& line);
+    // 取出累积的输入并复位
+    std::string take();
+    void reset();
+    int getDepth() const { return depth; }
+    // 是否有尚未闭合的括号、字符串或块注释
+    bool isOpen() const { return depth > 0 || inString || inBlockComment; }
+
+private:
+    std::string buffer;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    bool inBlockComment = false;
+    bool hasContent = false;
+};
 
-bool is_parentheses_balanced(const std::string& input);
-bool is_blockComment_balanced(const std::string& input);
 std::string readInput();
 
 void REPLmode();
+void REPLmode(std::shared_ptr<EvalEnv> env);
 void filemode(const std::string& input);
+// 读取输入流中的全部表达式；出现语法错误时 complete 置为 false
+std::vector<ValuePtr> readForms(std::istream& in, bool& complete);
+// 在给定环境中加载并执行源文件
+void loadFile(const std::string& filename, EvalEnv& env);
 
 #endif
\ No newline at end of file
@@ -1128,6 +1128,277 @@ RMLT_CASE("(define (len s) (if (eq? s '()) 0 (+ 1 (len (cdr s)))))")
 RMLT_CASE("(len '(1 2 3 4))", "4")
 RMLT_END_CASES()
 
+RMLT_BEGIN_CASES(Tooling)
+// 第二次载入时使用第一次写出的 FASL 缓存
+RMLT_CASE("(load-file \"test_file/lv7-answer.scm\")")
+RMLT_CASE("(load-file \"test_file/lv7-answer.scm\")")
+RMLT_CASE("(insert-sort '(3 1 2))", "(1 2 3)")
+RMLT_CASE("input-list", "(12 71 2 15 29 82 87 8 18 66 81 25 63 97 40 3 93 58 53 31 47)")
+// isolate 之间复制闭包与全局绑定
+RMLT_CASE("(define (sq x) (* x x))")
+RMLT_CASE("(isolate-join (isolate-spawn sq 7))", "49")
+RMLT_CASE("(define n 1)")
+RMLT_CASE("(isolate-join (isolate-spawn (lambda (x) (+ x n)) 41))", "42")
+RMLT_CASE("(define (adder k) (lambda (x) (+ x k)))")
+RMLT_CASE("(isolate-join (isolate-spawn (adder 10) 5))", "15")
+RMLT_CASE("(list? (runtime-stats))", "#t")
+RMLT_CASE("(car (car (runtime-stats)))", "eval-self-evaluating")
+RMLT_CASE("(time (+ 1 2))", "3")
+RMLT_CASE("(define (double x) (* 2 x))")
+RMLT_CASE("(trace double)")
+RMLT_CASE("(double 4)", "8")
+RMLT_CASE("(untrace double)")
+RMLT_CASE("(double 5)", "10")
+RMLT_END_CASES()
+
+RMLT_BEGIN_CASES(Data)
+RMLT_CASE("(equal? '(1 (2 #(3)) \"s\") '(1 (2 #(3)) \"s\"))", "#t")
+RMLT_CASE("(equal? '(1 2) '(1 2 3))", "#f")
+RMLT_CASE("(equal? 2 \"2\")", "#f")
+RMLT_CASE("(eq? 'a 'a)", "#t")
+RMLT_CASE("(eq? (list 1) (list 1))", "#f")
+RMLT_CASE("(define l (list 1 2))")
+RMLT_CASE("(eq? l l)", "#t")
+RMLT_CASE("(eqv? 1.5 1.5)", "#t")
+RMLT_CASE("(list)", "()")
+RMLT_CASE("(append '(1) '() '(2 3))", "(1 2 3)")
+RMLT_CASE("(append)", "()")
+RMLT_CASE("(map abs '(-1 2 -3))", "(1 2 3)")
+RMLT_CASE("(filter odd? '(1 2 3 4 5))", "(1 3 5)")
+RMLT_CASE("(define (range a b) (if (>= a b) '() (cons a (range (+ a 1) b))))")
+RMLT_CASE("(length (map abs (range 0 2000)))", "2000")
+RMLT_CASE("(length '(1 2 3))", "3")
+RMLT_CASE("(length '())", "0")
+RMLT_CASE("(list? '(1 . 2))", "#f")
+RMLT_CASE("(list? '(1 2))", "#t")
+RMLT_CASE("(length (range 0 5000))", "5000")
+RMLT_CASE("(define v (make-vector 3 0))")
+RMLT_CASE("(vector-set! v 0 'a)")
+RMLT_CASE("(vector->list v)", "(a 0 0)")
+RMLT_CASE("(vector-ref (vector 1 2 3) 1)", "2")
+RMLT_CASE("(vector-length #(1 2 3))", "3")
+RMLT_CASE("(vector? (list->vector '(1 2)))", "#t")
+RMLT_CASE("(vector? '(1 2))", "#f")
+RMLT_CASE("(vector->list (map (lambda (x) (* x x)) #(1 2 3)))", "(1 4 9)")
+RMLT_CASE("(define h (make-hash-table))")
+RMLT_CASE("(hash-set! h 'a 1)")
+RMLT_CASE("(hash-set! h \"k\" 2)")
+RMLT_CASE("(hash-set! h '(1 2) 3)")
+RMLT_CASE("(hash-ref h 'a)", "1")
+RMLT_CASE("(hash-ref h \"k\")", "2")
+RMLT_CASE("(hash-ref h (list 1 2))", "3")
+RMLT_CASE("(hash-ref h 'z 'none)", "none")
+RMLT_CASE("(hash-count h)", "3")
+RMLT_CASE("(hash-remove! h 'a)")
+RMLT_CASE("(hash-count h)", "2")
+RMLT_CASE("(hash-table? h)", "#t")
+RMLT_CASE("(sort '(3 1 2) <)", "(1 2 3)")
+RMLT_CASE("(sort '() <)", "()")
+RMLT_CASE("(vector->list (sort #(5 3 4) >))", "(5 4 3)")
+RMLT_CASE(
+    "(sort '((1 . a) (0 . b) (1 . c)) (lambda (x y) (< (car x) (car "
+    "y))))", "((0 . b) (1 . a) (1 . c))")
+RMLT_CASE("(define p (list 1 2 3))")
+RMLT_CASE("(set-car! p 10)")
+RMLT_CASE("(set-cdr! (cdr p) '(30))")
+RMLT_CASE("p", "(10 2 30)")
+RMLT_CASE("(define x 1)")
+RMLT_CASE("(set! x (+ x 1))")
+RMLT_CASE("x", "2")
+RMLT_CASE("(map + '(1 2 3) '(10 20))", "(11 22)")
+RMLT_CASE("(define acc '())")
+RMLT_CASE("(for-each (lambda (a b) (set! acc (cons (* a b) acc))) '(1 2) '(3 4))")
+RMLT_CASE("acc", "(8 3)")
+RMLT_CASE("(fold-left - 0 '(1 2 3))", "-6")
+RMLT_CASE("(fold-right cons '() '(1 2 3))", "(1 2 3)")
+RMLT_CASE("(fold-left (lambda (acc a b) (+ acc (* a b))) 0 '(1 2 3) '(4 5 6))", "32")
+RMLT_CASE("(reduce + '(1 2 3 4))", "10")
+// 带环的列表不是正规列表；与有限列表同步遍历时按有限列表的长度停止
+RMLT_CASE("(define ring (list 1 2))")
+RMLT_CASE("(set-cdr! (cdr ring) ring)")
+RMLT_CASE("(list? ring)", "#f")
+RMLT_CASE("(map + ring '(10 20 30))", "(11 22 31)")
+RMLT_CASE("(car (cdr (cdr (cdr ring))))", "2")
+RMLT_END_CASES()
+
+RMLT_BEGIN_CASES(Iteration)
+RMLT_CASE("(let loop ((i 0) (acc '())) (if (= i 3) acc (loop (+ i 1) (cons i acc))))", "(2 1 0)")
+RMLT_CASE("(do ((i 0 (+ i 1)) (s 0 (+ s i))) ((= i 5) s))", "10")
+RMLT_CASE("(do ((i 0 (+ i 1))) ((= i 3)))", "()")
+RMLT_CASE(
+    "(letrec ((ev? (lambda (n) (if (= n 0) #t (od? (- n 1))))) (od? (lambda (n) (if "
+    "(= n 0) #f (ev? (- n 1)))))) (ev? 10))", "#t")
+RMLT_CASE("(let* ((x 1) (y (+ x 1))) (* x y))", "2")
+RMLT_CASE("(define (count-up n) (let loop ((i 0)) (if (< i n) (loop (+ i 1)) i)))")
+RMLT_CASE("(count-up 10000)", "10000")
+// 循环变量与内置过程同名时原地更新，不影响全局绑定
+RMLT_CASE("(do ((max 0 (+ max 1))) ((= max 3) max))", "3")
+RMLT_CASE(
+    "(let loop ((min 5) (acc '())) (if (= min 0) acc (loop (- min 1) (cons min "
+    "acc))))", "(1 2 3 4 5)")
+RMLT_CASE(
+    "(letrec ((length (lambda (l) (if (null? l) 0 (+ 1 (length (cdr l))))))) (length "
+    "'(a b)))", "2")
+RMLT_CASE("(let* ((max 1) (max (+ max 1))) max)", "2")
+RMLT_CASE("(list (max 1 2) (min 1 2) (length '(1 2 3)))", "(2 1 3)")
+RMLT_END_CASES()
+
+RMLT_BEGIN_CASES(Parallel)
+RMLT_CASE("(define (sq x) (* x x))")
+RMLT_CASE("(pmap sq '(1 2 3 4 5))", "(1 4 9 16 25)")
+RMLT_CASE("(pmap sq '(1 2 3 4 5) 2)", "(1 4 9 16 25)")
+RMLT_CASE("(pmap sq '())", "()")
+RMLT_CASE("(parallel-for-each sq '(1 2 3))", "()")
+RMLT_CASE("(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))")
+RMLT_CASE("(pmap (lambda (n) (car (pmap fib (list n)))) '(10 15 20))", "(55 610 6765)")
+// pmap 中可以读取全局变量、修改过程调用自己的局部变量
+RMLT_CASE("(define base 100)")
+RMLT_CASE("(pmap (lambda (i) (+ i base)) '(1 2 3))", "(101 102 103)")
+RMLT_CASE("(pmap (lambda (i) (let ((n i)) (set! n (+ n 1)) n)) '(1 2 3))", "(2 3 4)")
+RMLT_CASE(
+    "(pmap (lambda (i) (define k (* i 10)) (do ((j 0 (+ j 1)) (s k (+ s 1))) ((= j "
+    "2) s))) '(1 2 3))", "(12 22 32)")
+RMLT_CASE("(touch (future (+ 1 2)))", "3")
+RMLT_CASE("(touch 5)", "5")
+RMLT_CASE("(future? (future 1))", "#t")
+RMLT_CASE("(future? 1)", "#f")
+RMLT_CASE("(touch (future (touch (future (* 6 7)))))", "42")
+RMLT_CASE("(define f (future (fib 15)))")
+RMLT_CASE("(define g 2)")
+RMLT_CASE("(* g (touch f))", "1220")
+RMLT_CASE("(define ch (make-channel 2))")
+RMLT_CASE("(channel? ch)", "#t")
+RMLT_CASE("(channel-send ch 1)")
+RMLT_CASE("(channel-recv ch)", "1")
+RMLT_CASE(
+    "(define producer (spawn (lambda () (do ((i 0 (+ i 1))) ((= i 3) (channel-close "
+    "ch)) (channel-send ch i)))))")
+RMLT_CASE(
+    "(let loop ((acc '()) (x (channel-recv ch 'done))) (if (eq? x 'done) acc (loop "
+    "(cons x acc) (channel-recv ch 'done))))", "(2 1 0)")
+RMLT_CASE("(channel-recv ch 'closed)", "closed")
+RMLT_CASE("(touch (spawn (lambda (a b) (+ a b)) 1 2))", "3")
+// 通道容量按请求的值计，不向上取到 2 的幂
+RMLT_CASE("(define c3 (make-channel 3))")
+RMLT_CASE(
+    "(list (channel-try-send c3 1) (channel-try-send c3 2) (channel-try-send c3 "
+    "3))", "(#t #t #t)")
+RMLT_CASE("(channel-try-send c3 4)", "#f")
+RMLT_CASE("(channel-recv c3)", "1")
+RMLT_CASE("(channel-try-send c3 4)", "#t")
+RMLT_CASE("(channel-try-send c3 5)", "#f")
+RMLT_CASE("(define c1 (make-channel 1))")
+RMLT_CASE("(list (channel-try-send c1 'a) (channel-try-send c1 'b))", "(#t #f)")
+RMLT_CASE("(channel-close c1)")
+RMLT_CASE("(channel-recv c1 'none)", "a")
+RMLT_CASE("(channel-recv c1 'none)", "none")
+// 多个任务同时修改同一个哈希表、向量或对子时逐次加锁，不丢失修改
+RMLT_CASE("(define keys (do ((i 0 (+ i 1)) (acc '() (cons i acc))) ((= i 5000) acc)))")
+RMLT_CASE("(define shared (make-hash-table))")
+RMLT_CASE("(parallel-for-each (lambda (k) (hash-set! shared k (* k 2))) keys 7)", "()")
+RMLT_CASE("(hash-count shared)", "5000")
+RMLT_CASE("(hash-ref shared 4999)", "9998")
+RMLT_CASE("(define shared2 (make-hash-table))")
+RMLT_CASE("(length (pmap (lambda (k) (hash-set! shared2 (list k) k)) keys 3))", "5000")
+RMLT_CASE("(hash-count shared2)", "5000")
+RMLT_CASE("(define slots (make-vector 5000 0))")
+RMLT_CASE(
+    "(parallel-for-each (lambda (k) (vector-set! slots k (vector-ref slots (- 4999 "
+    "k))) (vector-set! slots k k)) keys 5)", "()")
+RMLT_CASE("(vector-ref slots 1234)", "1234")
+RMLT_CASE("(define cell (list 0))")
+RMLT_CASE("(parallel-for-each (lambda (k) (set-car! cell k) (car cell)) keys)", "()")
+RMLT_CASE("(number? (car cell))", "#t")
+RMLT_END_CASES()
+
+RMLT_BEGIN_CASES(Streams)
+RMLT_CASE("(force (delay (+ 1 2)))", "3")
+RMLT_CASE("(promise? (make-promise 1))", "#t")
+RMLT_CASE("(force (make-promise 1))", "1")
+RMLT_CASE("(define count 0)")
+RMLT_CASE("(define p (delay (begin (set! count (+ count 1)) count)))")
+RMLT_CASE("(+ (force p) (force p))", "2")
+RMLT_CASE("(define s (cons-stream 1 (cons-stream 2 the-empty-stream)))")
+RMLT_CASE("(stream-car (stream-cdr s))", "2")
+RMLT_CASE("(stream-null? (stream-cdr (stream-cdr s)))", "#t")
+RMLT_CASE("(define (ints n) (cons-stream n (ints (+ n 1))))")
+RMLT_CASE("(define nat (ints 0))")
+RMLT_CASE("(stream-take nat 3)", "(0 1 2)")
+RMLT_CASE("(stream-take (stream-map (lambda (x) (* x x)) nat) 3)", "(0 1 4)")
+RMLT_CASE("(stream-take (stream-filter odd? nat) 3)", "(1 3 5)")
+// 含有流或通道的全局绑定不复制，不影响 isolate 的创建
+RMLT_CASE("(define held (list 1 (make-channel)))")
+RMLT_CASE("(define (sq x) (* x x))")
+RMLT_CASE("(isolate-join (isolate-spawn sq 7))", "49")
+// 带环或共享的全局结构按引用复制，isolate 中仍保持共享
+RMLT_CASE("(define ring (list 1 2 3))")
+RMLT_CASE("(set-cdr! (cdr (cdr ring)) ring)")
+RMLT_CASE("(define v (vector 0))")
+RMLT_CASE("(vector-set! v 0 v)")
+RMLT_CASE("(define a (list 1 2))")
+RMLT_CASE("(define b a)")
+RMLT_CASE("(isolate-join (isolate-spawn sq 3))", "9")
+RMLT_CASE("(isolate-join (isolate-spawn (lambda () (eq? a b))))", "#t")
+RMLT_CASE("(isolate-join (isolate-spawn (lambda () (car (cdr (cdr (cdr ring)))))))", "1")
+RMLT_CASE("(isolate-join (isolate-spawn (lambda () (eq? (vector-ref v 0) v))))", "#t")
+RMLT_CASE("(isolate-join (isolate-spawn (lambda (x y) (eq? x y)) a a))", "#t")
+RMLT_END_CASES()
+
+RMLT_BEGIN_CASES(Optimize)
+// 内联不能把变量实参推迟到有副作用的过程体之后求值
+RMLT_CASE("(define x 1)")
+RMLT_CASE("(define (bump) (set! x 100) 0)")
+RMLT_CASE("(define (f a) (+ (bump) a))")
+RMLT_CASE("(define (caller) (f x))")
+RMLT_CASE("(caller)", "1")
+RMLT_CASE("(define p (list 1 2))")
+RMLT_CASE("(define (clobber) (set-car! p 9) 0)")
+RMLT_CASE("(define (g a) (+ (clobber) a))")
+RMLT_CASE("(define (caller2) (g (car p)))")
+RMLT_CASE("(caller2)", "1")
+// 常量折叠与分支裁剪
+RMLT_CASE("(define (sq n) (* n n))")
+RMLT_CASE("(define (inc n) (+ n 1))")
+RMLT_CASE("(define (make) (lambda (v) (+ (- (sq (inc 1)) 4) (* 0 3) (if #t 1 2) v)))")
+RMLT_CASE("((make) 10)", "11")
+RMLT_CASE("((make) 10)", "11")
+RMLT_CASE("(define (pick) (cond (#f 1) ((= 1 2) 2) (else 3)))")
+RMLT_CASE("(pick)", "3")
+RMLT_CASE("(define (pick2 x) (cond (#f 1) (x 2) (else 3)))")
+RMLT_CASE("(pick2 #f)", "3")
+RMLT_CASE("(pick2 #t)", "2")
+RMLT_CASE("(define (k) (if (< 1 2) 'yes (car '())))")
+RMLT_CASE("(k)", "yes")
+// 重新定义后此前的化简失效，缓存的结果也不再复用
+RMLT_CASE("(define (sq n) (* n n n))")
+RMLT_CASE("((make) 10)", "15")
+RMLT_CASE(
+    "(define (collect n) (do ((i 0 (+ i 1)) (acc '() (cons ((lambda (v) (+ (sq 2) v)) i) acc))) "
+    "((= i n) acc)))")
+RMLT_CASE("(collect 3)", "(10 9 8)")
+RMLT_CASE("(define (sq n) n)")
+RMLT_CASE("(collect 3)", "(4 3 2)")
+// 内联
+RMLT_CASE("(define (double x) (* 2 x))")
+RMLT_CASE("(define (quad x) (double (double x)))")
+RMLT_CASE("(quad 3)", "12")
+RMLT_CASE("(define (double x) (+ x 1))")
+RMLT_CASE("(quad 3)", "5")
+RMLT_CASE("(define (shadow double) (lambda (x) (double x)))")
+RMLT_CASE("((shadow car) '(1 2))", "1")
+RMLT_CASE("(define (add3) (+ 1 2))")
+RMLT_CASE("(add3)", "3")
+RMLT_CASE("(set! + -)")
+RMLT_CASE("(add3)", "-1")
+// 只有依赖被修改的名字的过程体失效
+RMLT_CASE("(define (area r) (* r (* 2 3)))")
+RMLT_CASE("(define (smallest a) (max a (min 1 2)))")
+RMLT_CASE("(smallest 0)", "1")
+RMLT_CASE("(set! min max)")
+RMLT_CASE("(smallest 0)", "2")
+RMLT_CASE("(area 2)", "12")
+RMLT_END_CASES()
+
 #undef RMLT_BEGIN_CASES
 #undef RMLT_CASE
 #undef RMLT_END_CASES
@@ -0,0 +1,113 @@
+#include "./server.h"
+#include "./error.h"
+#include "./read.h"
+
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace {
+
+// 读取整个请求，直到客户端关闭写端
+std::string readRequest(int fd) {
+    std::string request;
+    char buffer[4096];
+    while (true) {
+        auto n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        request.append(buffer, n);
+    }
+    return request;
+}
+
+[[noreturn]] void handleRequest(int fd, EvalEnv& env) {
+    auto request = readRequest(fd);
+    // 输出与错误信息都写回客户端
+    std::cout.flush();
+    std::cerr.flush();
+    ::dup2(fd, STDOUT_FILENO);
+    ::dup2(fd, STDERR_FILENO);
+    ::close(fd);
+
+    std::istringstream in(request);
+    bool complete;
+    auto forms = readForms(in, complete);
+    for (const auto& form : forms) {
+        try {
+            std::cout << env.eval(form)->toString() << std::endl;
+        } catch (std::runtime_error& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+        }
+    }
+    std::cout.flush();
+    std::_Exit(0);
+}
+
+}  // namespace
+
+void serve(const std::string& socketPath, std::shared_ptr<EvalEnv> env) {
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        throw FileError("Socket path too long: " + socketPath);
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    // 只清理上次运行留下的套接字文件，路径上已有的其他文件不动
+    struct stat info;
+    if (::lstat(socketPath.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw FileError("Cannot listen on " + socketPath + ": file exists and is not a socket");
+        }
+        ::unlink(socketPath.c_str());
+    }
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw FileError("Cannot create socket");
+    }
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listener, SOMAXCONN) < 0) {
+        ::close(listener);
+        throw FileError("Cannot listen on " + socketPath + ": " + std::strerror(errno));
+    }
+    // 子进程退出后由系统自动回收
+    std::signal(SIGCHLD, SIG_IGN);
+    std::cerr << "serving on " << socketPath << std::endl;
+
+    while (true) {
+        int conn = ::accept(listener, nullptr, nullptr);
+        if (conn < 0) {
+            if (errno == EINTR) continue;
+            throw FileError("accept failed: "s + std::strerror(errno));
+        }
+        std::cout.flush();
+        auto pid = ::fork();
+        if (pid == 0) {
+            ::close(listener);
+            handleRequest(conn, *env);
+        }
+        if (pid < 0) {
+            std::cerr << "Error: fork failed: " << std::strerror(errno) << std::endl;
+        }
+        ::close(conn);
+    }
+}
+
+#else
+
+void serve(const std::string& socketPath, std::shared_ptr<EvalEnv> env) {
+    throw FileError("--serve is only supported on POSIX systems");
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <memory>
+#include <string>
+
+#include "./eval_env.h"
+
+// 批量求值服务：在 Unix 域套接字上监听，每个连接是一次求值请求。
+// 客户端发送源代码并关闭写端，服务端为每个请求 fork 出子进程，
+// 在全局环境的写时复制快照中求值，并把输出与各表达式的结果写回连接。
+void serve(const std::string& socketPath, std::shared_ptr<EvalEnv> env);
+
+#endif
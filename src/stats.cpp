@@ -0,0 +1,108 @@
+#include "./stats.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(__GLIBC__) || defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+bool collectingStats = false;
+std::atomic<std::uint64_t> statCounters[STAT_COUNT];
+
+namespace {
+
+constexpr const char* STAT_NAMES[STAT_COUNT] = {
+    "eval-self-evaluating", "eval-symbol", "eval-special-form", "eval-call",
+    "apply-builtin", "apply-lambda", "frames",
+    "values-boolean", "values-number", "values-string", "values-nil", "values-symbol", "values-pair",
+    "values-builtin", "values-lambda", "values-vector", "values-hash-table", "values-promise", "values-other",
+    "allocations",
+};
+
+std::atomic<std::int64_t> live{0};
+std::atomic<std::int64_t> peak{0};
+thread_local std::uint64_t threadAllocations = 0;
+
+// 按分配器实际给出的大小计数，释放时不必另存分配时的大小
+std::size_t usableSize(void* ptr) {
+#if defined(__GLIBC__)
+    return malloc_usable_size(ptr);
+#elif defined(_WIN32)
+    return _msize(ptr);
+#elif defined(__APPLE__)
+    return malloc_size(ptr);
+#else
+    (void)ptr;
+    return 0;
+#endif
+}
+
+void* allocate(std::size_t size) {
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    threadAllocations++;
+    if (collectingStats) {
+        statCounters[STAT_ALLOCATIONS].fetch_add(1, std::memory_order_relaxed);
+        std::int64_t bytes = usableSize(ptr);
+        std::int64_t now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        auto old = peak.load(std::memory_order_relaxed);
+        while (now > old && !peak.compare_exchange_weak(old, now, std::memory_order_relaxed)) {}
+    }
+    return ptr;
+}
+
+void release(void* ptr) {
+    if (!ptr) return;
+    if (collectingStats) live.fetch_sub(usableSize(ptr), std::memory_order_relaxed);
+    std::free(ptr);
+}
+
+void dump() {
+    for (const auto& [name, value] : statsSnapshot()) {
+        std::cerr << name << ' ' << value << std::endl;
+    }
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+
+void startStats(bool dumpAtExit) {
+    collectingStats = true;
+    if (dumpAtExit) std::atexit(dump);
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> statsSnapshot() {
+    std::vector<std::pair<std::string, std::uint64_t>> result;
+    for (int i = 0; i < STAT_COUNT; i++) {
+        result.emplace_back(STAT_NAMES[i], statCounters[i].load(std::memory_order_relaxed));
+    }
+    result.emplace_back("live-bytes", static_cast<std::uint64_t>(std::max<std::int64_t>(liveBytes(), 0)));
+    result.emplace_back("peak-bytes", static_cast<std::uint64_t>(peakBytes()));
+    return result;
+}
+
+std::uint64_t allocationCount() {
+    return statCounters[STAT_ALLOCATIONS].load(std::memory_order_relaxed);
+}
+
+std::int64_t liveBytes() {
+    return live.load(std::memory_order_relaxed);
+}
+
+std::int64_t peakBytes() {
+    return peak.load(std::memory_order_relaxed);
+}
+
+std::uint64_t threadAllocationCount() {
+    return threadAllocations;
+}
@@ -0,0 +1,58 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 运行时统计（--stats）：求值、调用、环境与值的分配次数，以及内存分配的字节数。
+// 计数器始终编译在内，只有开启后才累加；未开启时每处只多一次判断。
+enum StatCounter {
+    STAT_EVAL_SELF_EVALUATING,
+    STAT_EVAL_SYMBOL,
+    STAT_EVAL_SPECIAL_FORM,
+    STAT_EVAL_CALL,
+    STAT_APPLY_BUILTIN,
+    STAT_APPLY_LAMBDA,
+    STAT_FRAMES,
+    STAT_VALUE_BOOLEAN,
+    STAT_VALUE_NUMBER,
+    STAT_VALUE_STRING,
+    STAT_VALUE_NIL,
+    STAT_VALUE_SYMBOL,
+    STAT_VALUE_PAIR,
+    STAT_VALUE_BUILTIN,
+    STAT_VALUE_LAMBDA,
+    STAT_VALUE_VECTOR,
+    STAT_VALUE_HASH_TABLE,
+    STAT_VALUE_PROMISE,
+    STAT_VALUE_OTHER,
+    STAT_ALLOCATIONS,
+    STAT_COUNT,
+};
+
+// 在创建任何线程之前设置，之后只读
+extern bool collectingStats;
+extern std::atomic<std::uint64_t> statCounters[STAT_COUNT];
+
+inline void countStat(StatCounter counter) {
+    if (collectingStats) statCounters[counter].fetch_add(1, std::memory_order_relaxed);
+}
+
+// 开启统计，dumpAtExit 为真时在退出时把全部计数打印到标准错误输出
+void startStats(bool dumpAtExit);
+
+// 全部计数的名字与当前值，末尾是当前与峰值的存活字节数
+std::vector<std::pair<std::string, std::uint64_t>> statsSnapshot();
+
+// 开启统计以来经 operator new 分配的次数与字节数（当前存活 / 峰值）
+std::uint64_t allocationCount();
+std::int64_t liveBytes();
+std::int64_t peakBytes();
+
+// 当前线程的分配次数，不论是否开启统计都会累加，供 time 使用
+std::uint64_t threadAllocationCount();
+
+#endif
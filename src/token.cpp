@@ -23,6 +23,10 @@ TokenPtr Token::dot() {
     return TokenPtr(new Token(TokenType::DOT));
 }
 
+TokenPtr Token::vectorBegin() {
+    return TokenPtr(new Token(TokenType::VECTOR_BEGIN));
+}
+
 std::string Token::toString() const {
     switch (type) {
         case TokenType::LEFT_PAREN: return "(LEFT_PAREN)"; break;
@@ -31,6 +35,7 @@ std::string Token::toString() const {
         case TokenType::QUASIQUOTE: return "(QUASIQUOTE)"; break;
         case TokenType::UNQUOTE: return "(UNQUOTE)"; break;
         case TokenType::DOT: return "(DOT)"; break;
+        case TokenType::VECTOR_BEGIN: return "(VECTOR_BEGIN)"; break;
         default: return "(UNKNOWN)";
     }
 }
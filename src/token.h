@@ -14,6 +14,7 @@ enum class TokenType {
     QUASIQUOTE,
     UNQUOTE,
     DOT,
+    VECTOR_BEGIN,
     BOOLEAN_LITERAL,
     NUMERIC_LITERAL,
     STRING_LITERAL,
@@ -35,6 +36,7 @@ public:
 
     static TokenPtr fromChar(char c);
     static TokenPtr dot();
+    static TokenPtr vectorBegin();
 
     TokenType getType() const {
         return type;
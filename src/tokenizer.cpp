@@ -9,10 +9,11 @@
 const std::set<char> TOKEN_END{'(', ')', '\'', '`', ',', '"'};
 
 TokenPtr Tokenizer::nextToken(int& pos) {
-    while (pos < input.size()) {
+    const int size = static_cast<int>(input.size());
+    while (pos < size) {
         auto c = input[pos];
         if (c == ';') {
-            while (pos < input.size() && input[pos] != '\n') {
+            while (pos < size && input[pos] != '\n') {
                 pos++;
             }
         } else if (std::isspace(c)) {
@@ -21,6 +22,10 @@ TokenPtr Tokenizer::nextToken(int& pos) {
             pos++;
             return token;
         } else if (c == '#') {
+            if (pos + 1 < size && input[pos + 1] == '(') {
+                pos += 2;
+                return Token::vectorBegin();
+            }
             if (auto result = BooleanLiteralToken::fromChar(input[pos + 1])) {
                 pos += 2;
                 return result;
@@ -30,12 +35,12 @@ TokenPtr Tokenizer::nextToken(int& pos) {
         } else if (c == '"') {
             std::string string;
             pos++;
-            while (pos < input.size()) {
+            while (pos < size) {
                 if (input[pos] == '"') {
                     pos++;
                     return std::make_unique<StringLiteralToken>(string);
                 } else if (input[pos] == '\\') {
-                    if (pos + 1 >= input.size()) {
+                    if (pos + 1 >= size) {
                         throw SyntaxError("Unexpected end of string literal");
                     }
                     auto next = input[pos + 1];
@@ -55,7 +60,7 @@ TokenPtr Tokenizer::nextToken(int& pos) {
             int start = pos;
             do {
                 pos++;
-            } while (pos < input.size() && !std::isspace(input[pos]) &&
+            } while (pos < size && !std::isspace(input[pos]) &&
                      !TOKEN_END.contains(input[pos]));
             auto text = input.substr(start, pos - start);
             if (text == ".") {
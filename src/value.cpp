@@ -44,6 +44,18 @@ std::string PairValue::toString() const {
     return result;
 }
 
+void releaseChain(ValuePtr next) {
+    while (next && next.use_count() == 1) {
+        ValuePtr after = next->takeTail();
+        if (!after) break;
+        next = std::move(after);
+    }
+}
+
+PairValue::~PairValue() {
+    releaseChain(std::move(cdr));
+}
+
 std::string BuiltinProcValue::toString() const {
     return "#<procedure>";
 }
@@ -51,10 +63,14 @@ std::string BuiltinProcValue::toString() const {
 std::vector<ValuePtr> PairValue::toVector() const {
     std::vector<ValuePtr> result;
     const PairValue* current = this;
+    const PairValue* slow = this;
     while (current) {
         result.push_back(current->car);
         if (auto next = std::dynamic_pointer_cast<PairValue>(current->cdr)) {
             current = next.get();
+            // 慢指针每两步前进一次，追上说明列表带环
+            if (result.size() % 2 == 0) slow = static_cast<const PairValue*>(slow->cdr.get());
+            if (current == slow) throw LispError("Expected a proper list, got a cyclic one.");
         } else {
             if (!current->cdr->isNil()) {
                 result.push_back(current->cdr);
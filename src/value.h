@@ -2,6 +2,7 @@
 #define VALUE_H
 
 #include "./error.h"
+#include "./stats.h"
 #include <string>
 #include <memory>
 #include <optional>
@@ -11,7 +12,7 @@
 
 class Value{
 public:
-
+    Value() { countStat(STAT_VALUE_OTHER); }
     virtual ~Value() = default;
     virtual std::string toString() const { throw BugError("Oops, it is a base Value!"); }
     virtual std::string asString() const { throw BugError("Oops, it is not a String Value!"); }
@@ -29,6 +30,12 @@ public:
     virtual bool isProcedure() const { return false; }
     virtual bool isRational() const { return false; }
     virtual bool isMatrix() const { return false; }
+    virtual bool isVector() const { return false; }
+    virtual bool isHashTable() const { return false; }
+    // 能否复制到其他 isolate 或堆镜像中；线程、通道等进程内句柄不能
+    virtual bool isTransferable() const { return true; }
+    // 析构时交出链式结构的后继（对子的 cdr、已求值承诺的值），由调用方逐个释放，避免递归析构
+    virtual ValuePtr takeTail() { return nullptr; }
     virtual double asNumber() const {
         throw LispError("Cannot convert value to number.");
     }
@@ -39,6 +46,10 @@ public:
     virtual int getrows() const { throw BugError("Not a Matrix."); }
     virtual int getcols() const { throw BugError("Not a Matrix."); }
     
+
+protected:
+    // 派生类按自身类型计数
+    explicit Value(StatCounter kind) { countStat(kind); }
 };
 
 using ValuePtr = std::shared_ptr<Value>;
@@ -46,7 +57,7 @@ using ValuePtr = std::shared_ptr<Value>;
 
 class BooleanValue : public Value{
 public:
-    explicit BooleanValue(bool value) : value(value) {}
+    explicit BooleanValue(bool value) : Value(STAT_VALUE_BOOLEAN), value(value) {}
     std::string toString() const override;
     bool isSelfEvaluating() const override { return true; }
     bool isBool() const override { return true; }
@@ -59,7 +70,7 @@ private:
 
 class NumericValue : public Value{
 public:
-    explicit NumericValue(double value) : value(value) {}
+    explicit NumericValue(double value) : Value(STAT_VALUE_NUMBER), value(value) {}
     std::string toString() const override;
     bool isSelfEvaluating() const override { return true;}
     bool isNumber() const override { return true; }
@@ -71,9 +82,10 @@ protected:
 
 class StringValue : public Value{
 public:
-    explicit StringValue(const std::string& value) : value(value) {}
+    explicit StringValue(const std::string& value) : Value(STAT_VALUE_STRING), value(value) {}
     std::string toString() const override;
     std::string asString() const override { return value; }
+    const std::string& getValue() const { return value; }
     bool isSelfEvaluating() const override { return true;}
     bool isString() const override { return true; }
 
@@ -84,6 +96,7 @@ private:
 
 class NilValue : public Value{
 public:
+    NilValue() : Value(STAT_VALUE_NIL) {}
     std::string toString() const override;
     bool isNil() const override { return true; }
     
@@ -91,41 +104,87 @@ public:
 
 class SymbolValue : public Value{
 public:
-    explicit SymbolValue(const std::string& value) : value(value) {}
+    explicit SymbolValue(const std::string& value) : Value(STAT_VALUE_SYMBOL), value(value), hash(std::hash<std::string>{}(value)) {}
     std::string toString() const override;
     bool isSymbol() const override { return true; }
     std::optional<std::string> asSymbol() const override { return value; }
+    const std::string& getName() const { return value; }
+    // 构造时算好的名字哈希，符号作哈希表键时无需重复计算
+    std::size_t getHash() const { return hash; }
 
 private:
     std::string value;
+    std::size_t hash;
 };
 
+// 沿 takeTail 逐个释放只被独占引用的后继，长列表与长的流析构时不会递归过深
+void releaseChain(ValuePtr next);
+
 class PairValue : public Value{
 public:
-    explicit PairValue(const ValuePtr& car, const ValuePtr& cdr) : car(car), cdr(cdr) {}
+    explicit PairValue(ValuePtr car, ValuePtr cdr) : Value(STAT_VALUE_PAIR), car(std::move(car)), cdr(std::move(cdr)) {}
+    ~PairValue();
+    ValuePtr takeTail() override { return std::move(cdr); }
     std::string toString() const override;
     bool isPair() const override { return true; }
     std::vector<ValuePtr> toVector() const override;
     ValuePtr CAR() override { return car; }
     ValuePtr CDR() override { return cdr; }
+    const ValuePtr& getCar() const { return car; }
+    const ValuePtr& getCdr() const { return cdr; }
+    void setCar(ValuePtr value) { car = std::move(value); }
+    void setCdr(ValuePtr value) { cdr = std::move(value); }
 
 private:
     ValuePtr car;
     ValuePtr cdr;
 };
 
+// 列表构造器：自后向前一次遍历构造 [first, last) 组成的列表，tail 为最后一个对子的 cdr
+template <typename It>
+ValuePtr makeList(It first, It last, ValuePtr tail = std::make_shared<NilValue>()) {
+    ValuePtr result = std::move(tail);
+    while (last != first) {
+        --last;
+        result = std::make_shared<PairValue>(*last, std::move(result));
+    }
+    return result;
+}
+
+// 逐个访问列表元素，不构造中间 vector；遍历时持有当前对子，回调中修改列表也不会悬空
+template <typename F>
+void forEachInList(ValuePtr list, F&& f) {
+    // Brent 环检测：每走 2 的幂步把标记移到当前位置，再走回标记说明列表带环。
+    // 标记同样持有对子，回调截断列表时不会悬空
+    ValuePtr mark = list;
+    std::size_t power = 1, steps = 0;
+    while (list->isPair()) {
+        const auto& pair = static_cast<const PairValue&>(*list);
+        f(pair.getCar());
+        list = pair.getCdr();
+        if (list == mark) throw LispError("Expected a proper list, got a cyclic one.");
+        if (++steps == power) {
+            mark = list;
+            power *= 2;
+            steps = 0;
+        }
+    }
+}
 
 class BuiltinProcValue : public Value{
 public:
     using BuiltinFuncType = std::shared_ptr<Value>(const std::vector<ValuePtr>&);
 
-    BuiltinProcValue(std::function<BuiltinFuncType> func) : func(func) {}
+    BuiltinProcValue(std::function<BuiltinFuncType> func, const std::string& name = "") : Value(STAT_VALUE_BUILTIN), func(func), name(name) {}
     std::string toString() const override;
     bool isProcedure() const override { return true; }
-    std::function<BuiltinFuncType> getFunc() const { return func; }
+    const std::function<BuiltinFuncType>& getFunc() const { return func; }
+    // 内置过程注册时的名字，用于镜像保存后按名恢复
+    const std::string& getName() const { return name; }
     
 private:
     std::function<BuiltinFuncType> func;
+    std::string name;
 };
 
 
@@ -0,0 +1,11 @@
+#include "./vector_value.h"
+
+std::string VectorValue::toString() const {
+    std::string result = "#(";
+    for (std::size_t i = 0; i < elements.size(); i++) {
+        if (i != 0) result += " ";
+        result += elements[i]->toString();
+    }
+    result += ")";
+    return result;
+}
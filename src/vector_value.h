@@ -0,0 +1,23 @@
+#ifndef VECTOR_VALUE_H
+#define VECTOR_VALUE_H
+
+#include "./value.h"
+#include <vector>
+
+// 向量：连续存储的定长序列，支持 O(1) 下标访问
+class VectorValue : public Value {
+public:
+    VectorValue() : Value(STAT_VALUE_VECTOR) {}
+    explicit VectorValue(std::vector<ValuePtr> elements) : Value(STAT_VALUE_VECTOR), elements(std::move(elements)) {}
+    std::string toString() const override;
+    bool isSelfEvaluating() const override { return true; }
+    bool isVector() const override { return true; }
+    std::vector<ValuePtr>& getElements() { return elements; }
+    const std::vector<ValuePtr>& getElements() const { return elements; }
+    std::size_t size() const { return elements.size(); }
+
+private:
+    std::vector<ValuePtr> elements;
+};
+
+#endif
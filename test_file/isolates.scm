@@ -0,0 +1,35 @@
+; isolate 压力测试：同时运行多个 isolate，各自计算并与主线程交换消息
+(define isolate-count 16)
+(define rounds 200)
+
+(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))
+
+; 每个 isolate 先算一次 fib，再把收到的每条消息加上自己的编号送回，最后返回累计和
+(define (worker id)
+  (let loop ((i 0) (sum (fib 15)))
+    (if (= i rounds)
+        sum
+        (let ((message (isolate-receive)))
+          (isolate-send (cons id (+ message id)))
+          (loop (+ i 1) (+ sum message))))))
+
+(define (range a b) (if (>= a b) '() (cons a (range (+ a 1) b))))
+(define isolates (map (lambda (id) (isolate-spawn worker id)) (range 0 isolate-count)))
+
+(define errors 0)
+(do ((i 0 (+ i 1))) ((= i rounds))
+  (for-each (lambda (isolate) (isolate-send isolate i)) isolates)
+  (for-each (lambda (isolate id)
+              (let ((reply (isolate-receive isolate)))
+                (if (not (equal? reply (cons id (+ i id))))
+                    (set! errors (+ errors 1)))))
+            isolates
+            (range 0 isolate-count)))
+
+(define expected (+ (fib 15) (/ (* rounds (- rounds 1)) 2)))
+(for-each (lambda (isolate)
+            (if (not (= (isolate-join isolate) expected))
+                (set! errors (+ errors 1))))
+          isolates)
+(display (if (= errors 0) "isolates: ok" "isolates: FAILED"))
+(newline)